@@ -22,6 +22,7 @@
 
 #include "cojson.hpp"
 #include <stdint.h>
+#include <string.h>
 
 namespace cojson {
 namespace details {
@@ -32,10 +33,11 @@ namespace details {
 static inline bool ashex(char16_t v, ostream& out) noexcept {
 	/* rfc7159##section-7 allows only 4HEXDIG char codes */
 	unsigned char n = 4*4;
-	while(n-=4) {
+	do {
+		n -= 4;
 		char16_t c = (v >> n) & (char16_t)0xF;
 		if( ! out.put(ashex(c)) ) return false;
-	}
+	} while( n );
 	return true;
 } /* avr: 106 bytes */
 
@@ -97,6 +99,180 @@ bool reader<char_t*>::read(char_t* dst, size_t n, lexer& in) noexcept  {
 	return true;
 } /* avr: 456 bytes */
 
+namespace base64 {
+static inline int decode(char_t c) noexcept {
+	return
+		c >= 'A' && c <= 'Z' ? c - 'A' :
+		c >= 'a' && c <= 'z' ? c - 'a' + 26 :
+		c >= '0' && c <= '9' ? c - '0' + 52 :
+		c == '+' ? 62 : c == '/' ? 63 : -1;
+}
+
+static inline char_t encode(unsigned v) noexcept {
+	return static_cast<char_t>(
+		v < 26 ? 'A' + v :
+		v < 52 ? 'a' + v - 26 :
+		v < 62 ? '0' + v - 52 : v == 62 ? '+' : '/');
+}
+
+bool read(lexer& in, octetsink& sink) noexcept {
+	ctype ct;
+	if( ! isvalid(ct=in.value(ctype::stringnull)) )
+		return in.skip();
+	if( ct == ctype::null ) return true;
+	unsigned char buf[block];
+	size_t n = 0;
+	uint_fast32_t quad = 0;
+	unsigned q = 0, pad = 0;
+	char_t chr;
+	bool first = true;
+	while( (ct=in.string(chr, first)) == ctype::string ) {
+		first = false;
+		const int v = decode(chr);
+		if( chr == '=' && q >= 2 && q + pad < 4 ) {
+			++pad;
+			continue;
+		}
+		if( v < 0 || pad ) {
+			in.error(error_t::bad);
+			return in.skip_string(false);
+		}
+		quad = (quad << 6) | v;
+		if( ++q < 4 ) continue;
+		buf[n++] = quad >> 16;
+		buf[n++] = quad >> 8;
+		buf[n++] = quad;
+		quad = 0;
+		q = 0;
+		if( n == block ) {
+			if( ! sink.write(buf, n) ) {
+				in.error(error_t::overrun);
+				return in.skip_string(false);
+			}
+			n = 0;
+		}
+	}
+	if( ct != ctype::delim || q == 1 || (pad && q + pad != 4) ) {
+		in.error(error_t::bad);
+		return false;
+	}
+	/* unpadded tail is accepted as well */
+	if( q ) {
+		quad <<= 6 * (4 - q);
+		buf[n++] = quad >> 16;
+		if( q == 3 ) buf[n++] = quad >> 8;
+	}
+	if( n && ! sink.write(buf, n) ) in.error(error_t::overrun);
+	return true;
+}
+
+bool write(const unsigned char* src, size_t n, ostream& out) noexcept {
+	char_t buf[block / 3 * 4];
+	size_t k = 0;
+	if( ! out.put(literal::quotation_mark) ) return false;
+	for(size_t i = 0; i < n; i += 3) {
+		const size_t left = n - i;
+		const uint_fast32_t v = (uint_fast32_t(src[i]) << 16) |
+			(left > 1 ? uint_fast32_t(src[i+1]) << 8 : 0) |
+			(left > 2 ? src[i+2] : 0);
+		buf[k++] = encode(v >> 18);
+		buf[k++] = encode((v >> 12) & 0x3F);
+		buf[k++] = left > 1 ? encode((v >> 6) & 0x3F) : '=';
+		buf[k++] = left > 2 ? encode(v & 0x3F) : '=';
+		if( k == sizeof(buf)/sizeof(buf[0]) ) {
+			if( ! out.putn(buf, k) ) return false;
+			k = 0;
+		}
+	}
+	return (k == 0 || out.putn(buf, k)) && out.put(literal::quotation_mark);
+}
+} /* namespace base64 */
+
+void* arena::allocate(size_t n, size_t align) noexcept {
+	const size_t pad = (align - reinterpret_cast<uintptr_t>(base + used)
+			% align) % align;
+	if( pad > size - used || n > size - used - pad ) return nullptr;
+	used += pad;
+	void* ptr = base + used;
+	used += n;
+	return ptr;
+}
+
+bool string_view::read(lexer& in) noexcept {
+	ctype ct;
+	char_t chr;
+	ptr = nullptr;
+	len = 0;
+	if( ! isvalid(ct=in.value(ctype::stringnull)) )
+		return in.skip();
+	if( ct == ctype::null ) return true;
+	in.skipws(chr); /* opening quotation mark */
+	arena* mem = in.memory();
+	const char_t* begin = in.head();
+	size_t n = 0;
+	if( begin != nullptr ) {
+		while( (ct=in.string(chr, false)) == ctype::string ) ++n;
+		if( ct != ctype::delim && ct != ctype::eof ) return false;
+		const size_t raw = in.head() - begin - (ct == ctype::delim ? 1 : 0);
+		if( raw == n ) {
+			/* escape-free string, referenced in place */
+			ptr = begin;
+			len = n;
+			return true;
+		}
+		char_t* dst = mem ? mem->allocate<char_t>(n + 1) : nullptr;
+		if( dst == nullptr ) {
+			in.error(mem ? error_t::overrun : error_t::noobject);
+			return true;
+		}
+		/* second pass unescapes the string into the scratch memory */
+		buffer src(const_cast<char_t*>(begin), raw);
+		lexer esc(src);
+		for(len = 0; len < n; ++len) esc.string(dst[len], false);
+		dst[len] = 0;
+		ptr = dst;
+		return true;
+	}
+	/* not a contiguous input, decoding straight into the scratch memory */
+	if( mem == nullptr ) {
+		in.error(error_t::noobject);
+		return in.skip_string(false);
+	}
+	const size_t mark = mem->mark();
+	char_t* dst = mem->allocate<char_t>(0);
+	while( (ct=in.string(chr, false)) == ctype::string ) {
+		if( dst == nullptr || ! mem->extend(sizeof(char_t)) ) {
+			mem->release(mark);
+			in.error(error_t::overrun);
+			return in.skip_string(false);
+		}
+		dst[n++] = chr;
+	}
+	if( ct != ctype::delim && ct != ctype::eof ) {
+		mem->release(mark);
+		return false;
+	}
+	if( dst == nullptr || ! mem->extend(sizeof(char_t)) ) {
+		mem->release(mark);
+		in.error(error_t::overrun);
+		return true;
+	}
+	dst[n] = 0;
+	ptr = dst;
+	len = n;
+	return true;
+}
+
+bool string_view::write(ostream& out) const noexcept {
+	if( ptr == nullptr )
+		return value::null(out);
+	bool r = true;
+	if( ! out.put(literal::quotation_mark) ) return false;
+	for(size_t i = 0; i < len && r; ++i)
+		r = writer<const char_t*>::write(ptr[i], out);
+	return r && out.put(literal::quotation_mark);
+}
+
 template<typename T>
 class maker {
 public:
@@ -167,7 +343,54 @@ private:
 	int_fast8_t frac = 0;
 };
 
+/** reads double with the numlexer transition table */
+static inline bool scan(double& val, lexer& in) noexcept {
+	char_t chr = 0;
+	double pow = 1.;
+	int_fast16_t exp = 0;
+	bool neg = false;
+	bool eneg = false;
+	val = 0.;
+	if( ! isvalid(in.value(ctype::numeric)) ) return false;
+	const char_t* token = in.mark();
+	if( in.recall(val, token) ) return true;
+	numlexer::state st = numlexer::start;
+	while(true) switch( st = in.number(chr, st) ) {
+	case numlexer::integral:
+		val = val * 10. + (chr - literal::digit0);
+		continue;
+	case numlexer::fraction:
+		pow /= 10.;
+		val += (chr - literal::digit0) * pow;
+		continue;
+	case numlexer::expdigit:
+		if( exp < 1000 ) exp = exp * 10 + (chr - literal::digit0);
+		continue;
+	case numlexer::expsign:
+		eneg = chr == literal::minus;
+		continue;
+	case numlexer::minus:
+		neg = true;
+		/* no break */
+	case numlexer::zero:
+	case numlexer::dot:
+	case numlexer::exponent:
+		continue;
+	case numlexer::end:
+		if( chr != iostate::eos_c && ! isws(chr) ) in.back(chr);
+		if( neg ) val = -val;
+		if( exp ) val *= exp_10<double>(eneg ? -exp : exp);
+		in.remember(val, token);
+		return true;
+	default:
+		if( chr != iostate::err_c ) in.error(error_t::bad);
+		return false;
+	}
+}
+
 bool reader<double>::read(double& val, lexer& in) noexcept {
+	if( config::number_lexer == config::number_lexer_is::table )
+		return scan(val, in);
 	char_t digit = 0;
 	maker<double> maker(val);
 	ctype ct;
@@ -335,18 +558,40 @@ inline bool lexer::readable(const istream & in) noexcept {
 			(mismatch_is_error ? error_t::blocked : error_t::failed));
 }
 
+const numlexer::table_t numlexer::table {};
+const ctypetable::table_t ctypetable::table {};
+
+numlexer::state lexer::number(char_t& chr, numlexer::state st) noexcept {
+	if( ! trust && ! readable(stream) ) {
+		chr = iostate::err_c;
+		return numlexer::error;
+	}
+	if( hold ) {
+		chr = hold;
+		hold = 0;
+	} else if( ! stream.get(chr) ) {
+		return chr == iostate::eos_c && numlexer::complete(st) ?
+				numlexer::end : numlexer::error;
+	} else if( chr == literal::newline )
+		line = true;
+	st = numlexer::step(st, chr);
+	if( st < numlexer::end ) memo.push(chr);
+	return st;
+}
+
 ctype lexer::get(char_t& chr) noexcept {
-	if( ! readable(stream) ) return ctype::err;
+	if( ! trust && ! readable(stream) ) return ctype::err;
 	if( hold ) {
 		chr = hold;
 		hold = 0;
-		return chartype(chr);
+		return ctypeof(chr);
 	} else {
 		if( ! stream.get(chr) ) {
 			return bad(chr);
 		}
+		if( chr == literal::newline ) line = true;
 	}
-	return chartype(chr);
+	return ctypeof(chr);
 }
 
 inline ctype lexer::unhex(char_t& chr) noexcept {
@@ -438,6 +683,24 @@ bool lexer::member(char_t*& dst) noexcept {
 	return false;
 } /*avr: 598 bytes */
 
+bool lexer::next() noexcept {
+	char_t chr;
+	ctype ct;
+	const bool blocked = ! readable(stream);
+	if( (stream.error() & error_t::ioerror) != error_t::noerror ) return false;
+	stream.clear();
+	records = true;
+	if( blocked && ! line ) {
+		hold = 0;
+		while( isvalid(ct=get(chr)) && chr != literal::newline );
+		if( ! isvalid(ct) ) return false;
+	}
+	if( ! isvalid(skip(chr, ctype::whitespace)) ) return false;
+	back(chr);
+	line = false;
+	return true;
+} /* avr: 116 bytes */
+
 char_t lexer::skip_bom() noexcept {
 	char_t chr = 0;
 	ctype ct;
@@ -491,6 +754,12 @@ ctype lexer::value(ctype expected) noexcept {
 bool lexer::literal(cstring str) noexcept {
 	char_t chr;
 	ctype ct;
+	if( trust ) {
+		/* literal is known by its first character, skip the rest */
+		if( hold ) hold = 0; else stream.get(chr);
+		for(++str; *str; ++str) stream.get(chr);
+		return true;
+	}
 	while(*str && isvalid(get(chr))) {
 		if(*str != chr ) break;
 		++str;
@@ -511,21 +780,47 @@ bool value::null(ostream& out) noexcept {
 	return out.puts(literal::null_l());
 }
 
+bool ostream::putn(const char_t* s, size_t n) noexcept {
+	bool r = true;
+	while( n-- && (r = put(*s++)) );
+	return r;
+}
+
 bool ostream::_puts(const char_t* s) noexcept {
 	while( *s && put(*s++));
 	return *s == 0;
 }
 
+bool recordwriter::end(bool r) noexcept {
+	if( error() != error_t::noerror ) {
+		out.error(error());
+		clear();
+	}
+	if( ! (r && out.put(literal::newline)) ) return false;
+	++records;
+	++bytes;
+	if( (maxrecords && records >= maxrecords) ||
+		(maxbytes && bytes >= maxbytes) )
+		return flush();
+	return true;
+}
+
+bool recordwriter::flush() noexcept {
+	records = bytes = 0;
+	return flusher == nullptr || flusher(out);
+}
+
 bool object::write(ostream& out) const noexcept {
-	bool r = true;
+	bool r = true, first = true;
 	for(size_t i = 0; i<size && r ; ++i) {
 		const member& m(nodes[i]());
-		//TODO skip members with no value
-		r = dlm(i==0, out) &&
+		if( config::absent_omitted && ! m.has() ) continue;
+		r = dlm(first, out) &&
 			m.prolog(out)  &&
 			m.writeval(out);
+		first = false;
 	}
-	return r && end(out);
+	return r && (! first || dlm(true, out)) && end(out);
 }
 
 bool object::read(lexer& in, const char_t * name) const noexcept {
@@ -537,4 +832,551 @@ bool object::read(lexer& in, const char_t * name) const noexcept {
 	return false;
 }
 
+
+/******************************************************************************/
+/* validator																  */
+
+/** returns true if none of the eight octets at p ends a plain run of string
+ *  characters, i.e. is a quotation mark, reverse solidus, control or
+ *  non-ASCII character												*/
+static inline bool plain8(const char* p) noexcept {
+	static constexpr uint64_t ones = 0x0101010101010101ULL;
+	static constexpr uint64_t high = 0x8080808080808080ULL;
+	uint64_t w;
+	memcpy(&w, p, sizeof(w));
+	const uint64_t q = w ^ (ones * '"');
+	const uint64_t e = w ^ (ones * '\\');
+	return (((q - ones) & ~q) | ((e - ones) & ~e) | (w - ones * 0x20) | w)
+			& high ? false : true;
+}
+
+/** returns true for a string character not requiring validation			*/
+static inline bool plain(char_t c) noexcept {
+	typedef typename std::make_unsigned<char_t>::type uchar_t;
+	const uchar_t u = static_cast<uchar_t>(c);
+	return u >= 0x20 && c != literal::quotation_mark && c != literal::escape &&
+		(sizeof(char_t) > 1 || u < 0x80);
+}
+
+bool validator::open(bool object) noexcept {
+	if( depth >= maxdepth ) return false;
+	if( object )
+		nest[depth / 8] |=  (1 << (depth % 8));
+	else
+		nest[depth / 8] &= ~(1 << (depth % 8));
+	++depth;
+	st = object ? state::firstmember : state::first;
+	return true;
+}
+
+bool validator::close(bool object) noexcept {
+	if( depth == 0 ) return false;
+	--depth;
+	st = state::next;
+	return ((nest[depth / 8] >> (depth % 8)) & 1) == object;
+}
+
+bool validator::step(char_t c) noexcept {
+	typedef typename std::make_unsigned<char_t>::type uchar_t;
+	const uchar_t u = static_cast<uchar_t>(c);
+	const bool ws = c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	switch( st ) {
+	case state::first:
+		if( c == literal::end_array ) return close(false);
+		/* no break */
+	case state::value:
+		if( ws ) return true;
+		switch( c ) {
+		case literal::begin_object:	return open(true);
+		case literal::begin_array:	return open(false);
+		case literal::quotation_mark:
+			st = state::string;
+			aux = 0;
+			return true;
+		case 't': lit = "rue";  break;
+		case 'f': lit = "alse"; break;
+		case 'n': lit = "ull";  break;
+		default:
+			aux = numlexer::next(numlexer::start,
+					numlexer::classify(u < 128 ? u : 128));
+			st = state::number;
+			return aux != numlexer::error;
+		}
+		st = state::literal;
+		return true;
+	case state::firstmember:
+		if( c == literal::end_object ) return close(true);
+		/* no break */
+	case state::member:
+		if( ws ) return true;
+		st = state::string;
+		aux = 1;
+		return c == literal::quotation_mark;
+	case state::colon:
+		if( ws ) return true;
+		st = state::value;
+		return c == literal::name_separator;
+	case state::next:
+		if( ws ) return true;
+		if( depth == 0 ) return false;
+		switch( c ) {
+		case literal::value_separator:
+			st = (nest[(depth-1) / 8] >> ((depth-1) % 8)) & 1 ?
+				state::member : state::value;
+			return true;
+		case literal::end_array:	return close(false);
+		case literal::end_object:	return close(true);
+		default:					return false;
+		}
+	case state::string:
+		if( c == literal::quotation_mark ) {
+			st = aux ? state::colon : state::next;
+			return true;
+		}
+		if( c == literal::escape ) {
+			st = state::escape;
+			return true;
+		}
+		if( u < 0x20 ) return false;
+		if( sizeof(char_t) > 1 || u < 0x80 ) return true;
+		/* RFC 3629 section 4, first continuation octet is constrained to
+		 * reject overlong forms, surrogates and code points above 10FFFF	*/
+		st = state::utf8;
+		lo = 0x80; hi = 0xBF;
+		if( u >= 0xC2 && u <= 0xDF ) need = 1; else
+		if( u >= 0xE0 && u <= 0xEF ) {
+			need = 2;
+			if( u == 0xE0 ) lo = 0xA0;
+			if( u == 0xED ) hi = 0x9F;
+		} else
+		if( u >= 0xF0 && u <= 0xF4 ) {
+			need = 3;
+			if( u == 0xF0 ) lo = 0x90;
+			if( u == 0xF4 ) hi = 0x8F;
+		} else
+			return false;
+		return true;
+	case state::utf8:
+		if( u < lo || u > hi ) return false;
+		lo = 0x80; hi = 0xBF;
+		if( --need == 0 ) st = state::string;
+		return true;
+	case state::escape:
+		st = state::string;
+		if( c == literal::hex_mark ) {
+			st = state::hex;
+			need = 4;
+			return true;
+		}
+		return	c == '"' || c == '\\' || c == '/' || c == 'b' || c == 'f' ||
+				c == 'n' || c == 'r' || c == 't';
+	case state::hex:
+		if( --need == 0 ) st = state::string;
+		return	(c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') ||
+				(c >= 'A' && c <= 'F');
+	case state::number:
+		aux = numlexer::next(static_cast<numlexer::state>(aux),
+				numlexer::classify(u < 128 ? u : 128));
+		if( aux == numlexer::end ) {
+			st = state::next;
+			return step(c);
+		}
+		return aux != numlexer::error;
+	case state::literal:
+		if( c != static_cast<char_t>(*lit) ) return false;
+		if( *++lit == 0 ) st = state::next;
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool validator::feed(const char_t* text, size_t n) noexcept {
+	const char_t* const begin = text;
+	const char_t* const end = text + n;
+	while( text != end ) {
+		if( st == state::string ) {
+			/* plain string characters are skipped without state changes */
+			if( sizeof(char_t) == 1 && sizeof(void*) >= 4 ) {
+				while( end - text >= 8 &&
+						plain8(reinterpret_cast<const char*>(text)) )
+					text += 8;
+			}
+			while( text != end && plain(*text) ) ++text;
+			if( text == end ) break;
+		}
+		if( ! step(*text) ) {
+			st = state::failed;
+			pos += text - begin;
+			return false;
+		}
+		++text;
+	}
+	pos += n;
+	return true;
+}
+
+bool validator::finish() noexcept {
+	if( st == state::number &&
+			numlexer::complete(static_cast<numlexer::state>(aux)) )
+		st = state::next;
+	return st == state::next && depth == 0;
+}
+
+bool validate(const char_t* text, size_t n, size_t* offset) noexcept {
+	validator v;
+	const bool r = v.feed(text, n) && v.finish();
+	if( offset ) *offset = v.offset();
+	return r;
+}
+
+bool validate(istream& in, size_t* offset) noexcept {
+	validator v;
+	char_t block[32];
+	size_t n;
+	bool r;
+	do {
+		for(n = 0; n < sizeof(block)/sizeof(block[0]) && in.get(block[n]);)
+			++n;
+	} while( (r = v.feed(block, n)) && n == sizeof(block)/sizeof(block[0]) );
+	r = r && (in.error() & error_t::failed) == error_t::noerror && v.finish();
+	if( offset ) *offset = v.offset();
+	if( ! r ) in.error(error_t::bad);
+	return r;
+}
+
+
+/******************************************************************************/
+/* canonical form filter													  */
+
+/**
+ * Output window of the filter. Text is staged in the window and written
+ * out with putn when the window is full or the value is complete.
+ * Objects are sorted in place while they are still in the window,
+ * gen tells if the window was flushed since an object has started
+ */
+class canonical : public ostream {
+public:
+	static constexpr size_t maxdepth = 32;
+	static constexpr size_t maxkeys = 16;
+	inline canonical(ostream& o, char_t* w, size_t n, bool s) noexcept
+	  : out(o), win(w), size(n), used(0), gen(0), sort(s) {}
+	bool put(char_t c) noexcept {
+		if( used == size && ! flush() ) return false;
+		win[used++] = c;
+		return true;
+	}
+	bool filter(lexer& in) noexcept {
+		return value(in, 0) && flush();
+	}
+private:
+	bool flush() noexcept {
+		const size_t n = used;
+		used = 0;
+		++gen;
+		return n == 0 || out.putn(win, n);
+	}
+	static inline bool bad(lexer& in) noexcept {
+		in.error(error_t::bad);
+		return false;
+	}
+	bool value(lexer& in, size_t depth) noexcept;
+	bool object(lexer& in, size_t depth) noexcept;
+	bool array(lexer& in, size_t depth) noexcept;
+	bool string(lexer& in) noexcept;
+	bool number(lexer& in) noexcept;
+	bool codepoint(uint_fast32_t cp) noexcept;
+	void order(size_t* off, size_t n) noexcept;
+	ostream& out;
+	char_t* const win;
+	const size_t size;
+	size_t used;
+	size_t gen;
+	const bool sort;
+};
+
+bool canonical::value(lexer& in, size_t depth) noexcept {
+	char_t chr;
+	if( ! isvalid(in.skip(chr, ctype::whitespace)) ) return bad(in);
+	switch( chr ) {
+	case literal::begin_object:
+		return depth < maxdepth ? object(in, depth + 1) : bad(in);
+	case literal::begin_array:
+		return depth < maxdepth ? array(in, depth + 1) : bad(in);
+	case literal::quotation_mark:
+		return string(in);
+	case literal_strings<char_t>::true_l()[0]:
+	case literal_strings<char_t>::false_l()[0]:
+	case literal_strings<char_t>::null_l()[0]:
+		in.back(chr);
+		{
+			const ctype ct = in.value(ctype::literal);
+			if( ct == ctype::null )		return puts(literal::null_l());
+			if( ct == ctype::boolean )	return puts(literal::false_l());
+			if( ct == (ctype::boolean | ctype::value) )
+				return puts(literal::true_l());
+			return bad(in);
+		}
+	default:
+		in.back(chr);
+		return number(in);
+	}
+}
+
+bool canonical::array(lexer& in, size_t depth) noexcept {
+	char_t chr;
+	if( ! put(literal::begin_array) ) return false;
+	if( ! in.skipws(chr) ) return bad(in);
+	if( chr != literal::end_array ) {
+		in.back(chr);
+		do {
+			if( ! value(in, depth) ) return false;
+			if( ! in.skipws(chr) ) return bad(in);
+			if( chr == literal::end_array ) break;
+			if( chr != literal::value_separator ) return bad(in);
+		} while( put(literal::value_separator) );
+	}
+	return put(literal::end_array);
+}
+
+/* Members are staged as units, each starting with its separator, the first
+ * one with {. Sorting permutes the units and then fixes the separators	*/
+bool canonical::object(lexer& in, size_t depth) noexcept {
+	char_t chr;
+	size_t off[maxkeys + 1];
+	size_t n = 0;
+	if( ! put(literal::begin_object) ) return false;
+	const size_t g = gen;
+	off[0] = used - 1;
+	if( ! in.skipws(chr) ) return bad(in);
+	if( chr != literal::end_object ) {
+		for(;;) {
+			if( chr != literal::quotation_mark ) return bad(in);
+			if( ! string(in) ) return false;
+			if( ! in.skipws(chr) || chr != literal::name_separator )
+				return bad(in);
+			if( ! put(literal::name_separator) || ! value(in, depth) )
+				return false;
+			if( n < maxkeys ) off[++n] = used;
+			else n = maxkeys + 1;
+			if( ! in.skipws(chr) ) return bad(in);
+			if( chr == literal::end_object ) break;
+			if( chr != literal::value_separator ) return bad(in);
+			if( ! put(literal::value_separator) ) return false;
+			if( ! in.skipws(chr) ) return bad(in);
+		}
+		if( sort && g == gen && n > 1 && n <= maxkeys ) {
+			order(off, n);
+			win[off[0]] = literal::begin_object;
+			for(size_t i = 1; i < n; ++i)
+				win[off[i]] = literal::value_separator;
+		}
+	}
+	return put(literal::end_object);
+}
+
+/** compares keys of two staged members, skipping the leading separator	*/
+static int keycmp(const char_t* a, const char_t* b) noexcept {
+	typedef typename std::make_unsigned<char_t>::type uchar_t;
+	for(a += 2, b += 2; ; ++a, ++b) {
+		const bool ea = *a == literal::quotation_mark;
+		const bool eb = *b == literal::quotation_mark;
+		if( ea || eb ) return ea == eb ? 0 : ea ? -1 : 1;
+		if( *a == literal::escape && *b == literal::escape ) {
+			++a; ++b;
+		}
+		if( *a != *b )
+			return static_cast<uchar_t>(*a) < static_cast<uchar_t>(*b) ? -1 : 1;
+	}
+}
+
+static void reverse(char_t* first, char_t* last) noexcept {
+	while( first < last ) {
+		const char_t c = *first;
+		*first++ = *--last;
+		*last = c;
+	}
+}
+
+/* insertion sort of units, moved in place by rotation, stable			*/
+void canonical::order(size_t* off, size_t n) noexcept {
+	for(size_t i = 1; i < n; ++i) {
+		size_t j = 0;
+		while( j < i && keycmp(win + off[j], win + off[i]) <= 0 ) ++j;
+		if( j == i ) continue;
+		const size_t len = off[i+1] - off[i];
+		reverse(win + off[j], win + off[i]);
+		reverse(win + off[i], win + off[i+1]);
+		reverse(win + off[j], win + off[i+1]);
+		for(size_t k = i; k > j; --k) off[k] = off[k-1] + len;
+	}
+}
+
+static inline int hexval(char_t c) noexcept {
+	return	c >= '0' && c <= '9' ? c - '0' :
+			c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+			c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+}
+
+/** reads four hex digits of a \u escape, returns -1 on error			*/
+static long unhex4(lexer& in) noexcept {
+	long v = 0;
+	char_t chr;
+	for(int i = 0; i < 4; ++i) {
+		const int h = in.get(chr, ctype::string) < ctype::unknown ? -1 :
+			hexval(chr);
+		if( h < 0 ) return -1;
+		v = (v << 4) | h;
+	}
+	return v;
+}
+
+/** writes a code point decoded from \u escapes in UTF-8 or as is		*/
+bool canonical::codepoint(uint_fast32_t cp) noexcept {
+	if( cp < 0x80 )
+		return writer<const char_t*>::write(static_cast<char_t>(cp), *this);
+	if( sizeof(char_t) > 1 ) {
+		if( sizeof(char_t) == 2 && cp > 0xFFFF )
+			return	put(static_cast<char_t>(0xD800 + ((cp - 0x10000) >> 10))) &&
+					put(static_cast<char_t>(0xDC00 + (cp & 0x3FF)));
+		return put(static_cast<char_t>(cp));
+	}
+	if( cp < 0x800 )
+		return	put(static_cast<char_t>(0xC0 | (cp >> 6))) &&
+				put(static_cast<char_t>(0x80 | (cp & 0x3F)));
+	if( cp < 0x10000 )
+		return	put(static_cast<char_t>(0xE0 | (cp >> 12))) &&
+				put(static_cast<char_t>(0x80 | ((cp >> 6) & 0x3F))) &&
+				put(static_cast<char_t>(0x80 | (cp & 0x3F)));
+	return	put(static_cast<char_t>(0xF0 | (cp >> 18))) &&
+			put(static_cast<char_t>(0x80 | ((cp >> 12) & 0x3F))) &&
+			put(static_cast<char_t>(0x80 | ((cp >> 6) & 0x3F))) &&
+			put(static_cast<char_t>(0x80 | (cp & 0x3F)));
+}
+
+/* opening quotation mark is already read								*/
+bool canonical::string(lexer& in) noexcept {
+	typedef typename std::make_unsigned<char_t>::type uchar_t;
+	char_t chr;
+	if( ! put(literal::quotation_mark) ) return false;
+	for(;;) {
+		if( in.get(chr, ctype::string) < ctype::unknown ||
+				static_cast<uchar_t>(chr) < 0x20 )
+			return bad(in);
+		if( chr == literal::quotation_mark )
+			return put(literal::quotation_mark);
+		if( chr != literal::escape ) {
+			if( ! put(chr) ) return false;
+			continue;
+		}
+		if( in.get(chr, ctype::string) < ctype::unknown ) return bad(in);
+		long cp;
+		switch( chr ) {
+		case '"': case '\\': case '/':	cp = chr;	break;
+		case 'b':	cp = '\b';	break;
+		case 'f':	cp = '\f';	break;
+		case 'n':	cp = '\n';	break;
+		case 'r':	cp = '\r';	break;
+		case 't':	cp = '\t';	break;
+		case 'u':
+			if( (cp = unhex4(in)) < 0 ) return bad(in);
+			if( cp >= 0xD800 && cp <= 0xDBFF ) {
+				/* surrogate pair, a lone surrogate is an error			*/
+				long lo;
+				if( in.get(chr, ctype::string) < ctype::unknown ||
+					chr != literal::escape ||
+					in.get(chr, ctype::string) < ctype::unknown ||
+					chr != literal::hex_mark ||
+					(lo = unhex4(in)) < 0xDC00 || lo > 0xDFFF )
+					return bad(in);
+				cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+			} else if( cp >= 0xDC00 && cp <= 0xDFFF )
+				return bad(in);
+			break;
+		default:
+			return bad(in);
+		}
+		if( ! codepoint(cp) ) return false;
+	}
+}
+
+/* Numbers are normalized lexically, so the value is exact: no plus sign,
+ * no trailing fraction zeros, lowercase exponent without leading zeros,
+ * zero exponents and zero values are written as 0						*/
+bool canonical::number(lexer& in) noexcept {
+	numlexer::state st = numlexer::start;
+	char_t chr;
+	ctype ct;
+	bool neg = false, nonzero = false, dot = false, exp = false;
+	bool expneg = false;
+	size_t zeros = 0;
+	do {
+		if( config::number_lexer == config::number_lexer_is::table ) {
+			st = in.number(chr, st);
+			ct = chr == iostate::eos_c ? ctype::eof : ctype::number;
+		} else {
+			ct = in.get(chr, ctype::number);
+			if( ct < ctype::unknown && ct != ctype::eof ) return bad(in);
+			st = numlexer::next(st, ct == ctype::eof ? numlexer::cls::delim
+				: numlexer::classify(static_cast<unsigned>(chr)));
+		}
+		switch( st ) {
+		case numlexer::minus:
+			neg = true;
+			break;
+		case numlexer::integral:
+			if( ! nonzero ) {
+				if( neg && ! put(literal::minus) ) return false;
+				nonzero = true;
+			}
+			if( ! put(chr) ) return false;
+			break;
+		case numlexer::fraction:
+			if( chr == literal::digit0 ) {
+				++zeros;
+				break;
+			}
+			if( ! nonzero ) {
+				if( neg && ! put(literal::minus) ) return false;
+				if( ! put(literal::digit0) ) return false;
+				nonzero = true;
+			}
+			if( ! dot && ! put(literal::decimal) ) return false;
+			dot = true;
+			for(; zeros; --zeros)
+				if( ! put(literal::digit0) ) return false;
+			if( ! put(chr) ) return false;
+			break;
+		case numlexer::expsign:
+			expneg = chr == literal::minus;
+			break;
+		case numlexer::expdigit:
+			if( ! nonzero || (! exp && chr == literal::digit0) ) break;
+			if( ! exp && ! (put('e') && (! expneg || put(literal::minus))) )
+				return false;
+			exp = true;
+			if( ! put(chr) ) return false;
+			break;
+		case numlexer::error:
+			if( chr != iostate::err_c ) in.error(error_t::bad);
+			return false;
+		default:
+			break;
+		}
+	} while( st != numlexer::end );
+	if( ct != ctype::eof && ! isws(chr) ) in.back(chr);
+	return nonzero || put(literal::digit0);
+}
+
+bool minify(lexer& in, ostream& out) noexcept {
+	char_t window[32];
+	return canonical(out, window, sizeof(window)/sizeof(window[0]), false)
+		.filter(in);
+}
+
+bool canonicalize(lexer& in, ostream& out, char_t* window, size_t size)
+		noexcept {
+	return canonical(out, window, size, true).filter(in);
+}
+
 }}
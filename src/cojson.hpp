@@ -29,6 +29,7 @@ namespace cojson {
 
 	struct config : configuration::Configuration<config> {
 		static constexpr bool null_is_error = null == null_is::error;
+		static constexpr bool absent_omitted = absent == absent_is::omitted;
 	private:
 		config();
 	};
@@ -259,6 +260,94 @@ struct functions {
 private:
 	functions();
 };
+
+/*
+ * Generators produce array elements lazily while the array is written.
+ * Instead of get(i)/has(i) they provide each(w), which passes every element
+ * to w until w returns false. Generated arrays are write-only
+ */
+
+/**
+ * Generator via callback F, called with the index of the element to
+ * produce, returns false when there are no more elements.
+ * Index 0 starts a new sequence
+ */
+template<typename T, bool (*F)(T&, size_t) noexcept>
+struct generator {
+	typedef T clas;
+	typedef T type;
+	static constexpr bool canget = true;
+	static constexpr bool canset = false;
+	static constexpr bool canlref   = false;
+	static constexpr bool canrref   = false;
+	static constexpr bool is_vector = true;
+	static constexpr bool is_generator = true;
+	template<class W>
+	static inline bool each(W w) noexcept {
+		T item;
+		for(size_t i = 0; F(item, i); ++i)
+			if( ! w(static_cast<const T&>(item)) ) return false;
+		return true;
+	}
+	static inline constexpr bool null(void_t) noexcept {
+		return not config::null_is_error;
+	}
+private:
+	generator();
+};
+
+/**
+ * Generator over a pair of forward iterators returned by B and E
+ */
+template<typename I, I (*B)() noexcept, I (*E)() noexcept>
+struct iterators {
+	typedef typename std::decay<decltype(*B())>::type clas;
+	typedef typename std::decay<decltype(*B())>::type type;
+	static constexpr bool canget = true;
+	static constexpr bool canset = false;
+	static constexpr bool canlref   = false;
+	static constexpr bool canrref   = false;
+	static constexpr bool is_vector = true;
+	static constexpr bool is_generator = true;
+	template<class W>
+	static inline bool each(W w) noexcept {
+		for(I i = B(), e = E(); i != e; ++i)
+			if( ! w(*i) ) return false;
+		return true;
+	}
+	static inline constexpr bool null(void_t) noexcept {
+		return not config::null_is_error;
+	}
+private:
+	iterators();
+};
+
+/**
+ * Generator over a range returned by F, a container or a view with
+ * begin() and end(). R may be a reference type
+ */
+template<typename R, R (*F)() noexcept>
+struct range {
+	typedef typename std::decay<decltype(*F().begin())>::type clas;
+	typedef typename std::decay<decltype(*F().begin())>::type type;
+	static constexpr bool canget = true;
+	static constexpr bool canset = false;
+	static constexpr bool canlref   = false;
+	static constexpr bool canrref   = false;
+	static constexpr bool is_vector = true;
+	static constexpr bool is_generator = true;
+	template<class W>
+	static inline bool each(W w) noexcept {
+		for(auto&& v : F())
+			if( ! w(v) ) return false;
+		return true;
+	}
+	static inline constexpr bool null(void_t) noexcept {
+		return not config::null_is_error;
+	}
+private:
+	range();
+};
 } /* namespace accessor */
 
 
@@ -350,6 +439,7 @@ struct literal : literal_strings<char_l> {
 	static constexpr char_t digitA			= 'A'; /** A 					  */
 	static constexpr char_t digita			= 'a'; /** A 					  */
 	static constexpr char_t ws 				= ' ';
+	static constexpr char_t newline			= '\n';/** NDJSON record separator */
 
 	/* the characters that must be escaped:
 	 * quotation mark, reverse solidus,
@@ -534,6 +624,23 @@ struct istream : virtual iostate {
 	 * in latter case dst holds error code (fail or eof)
 	 */
 	virtual bool get(char_t& dst) noexcept = 0;
+	/**
+	 * returns pointer to the next character if the stream is backed by
+	 * a contiguous memory buffer, or nullptr otherwise
+	 */
+	virtual const char_t* head() const noexcept { return nullptr; }
+	/**
+	 * returns how many of the next n characters are readable at head(),
+	 * 0 if the stream is not contiguous
+	 */
+	virtual size_t ahead(size_t) const noexcept { return 0; }
+	/**
+	 * advances head by n characters, previously inspected via head()
+	 */
+	virtual void advance(size_t n) noexcept {
+		char_t chr;
+		while( n-- && get(chr) );
+	}
 };
 
 /**
@@ -556,6 +663,12 @@ struct ostream : virtual iostate {
 		while(*s && res) res = put(*s++);
 		return  res;
 	}
+	/**
+	 * writes n characters from s to the stream, streams with contiguous
+	 * storage override it with a bulk copy.
+	 * returns true on success or false on error
+	 */
+	virtual bool putn(const char_t* s, size_t n) noexcept;
 protected:
 	virtual bool _puts(const char_t* s) noexcept;
 };
@@ -586,6 +699,41 @@ struct temporary_s<T, N, true> {
 	}
 };
 
+/**
+ * Monotonic scratch memory for data decoded during a read, such as
+ * unescaped strings. Lifetime of the allocated data is the lifetime of
+ * the request; all memory is released at once with reset()
+ */
+class arena : noncopyable {
+public:
+	inline arena(void* mem, size_t n) noexcept
+	  : base(static_cast<unsigned char*>(mem)), size(n), used(0) {}
+	template<typename T, size_t N>
+	inline arena(T (&mem)[N]) noexcept : arena(mem, sizeof(mem)) {}
+	/** allocates n bytes aligned to align, returns nullptr if exhausted */
+	void* allocate(size_t n, size_t align = 1) noexcept;
+	template<typename T>
+	inline T* allocate(size_t n) noexcept {
+		return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+	}
+	/** extends the most recent allocation by n bytes */
+	inline bool extend(size_t n) noexcept {
+		if( n > size - used ) return false;
+		used += n;
+		return true;
+	}
+	inline size_t mark() const noexcept { return used; }
+	inline void release(size_t m) noexcept { if( m < used ) used = m; }
+	inline void reset() noexcept { used = 0; }
+	inline size_t available() const noexcept { return size - used; }
+	inline bool owns(const void* p) const noexcept {
+		return p >= base && p < base + size;
+	}
+private:
+	unsigned char* const base;
+	const size_t size;
+	size_t used;
+};
 
 enum class ctype : int {
 	unknown		= 0,
@@ -651,15 +799,293 @@ static inline constexpr ctype andmask(ctype ct, ctype mask) noexcept {
 	return ct <= ctype::unknown ? ct : (ct & mask);
 }
 
+/* index sequence for generating tables, composing texts and copying them
+ * into arrays */
+template<size_t ... I>
+struct indices {};
+
+template<class A, class B>
+struct concat;
+
+template<size_t ... I, size_t ... J>
+struct concat<indices<I...>, indices<J...>> {
+	typedef indices<I..., (sizeof...(I) + J)...> type;
+};
+
+template<size_t N>
+struct make_indices {
+	typedef typename concat<typename make_indices<N / 2>::type,
+		typename make_indices<N - N / 2>::type>::type type;
+};
+
+template<>
+struct make_indices<0> {
+	typedef indices<> type;
+};
+
+template<>
+struct make_indices<1> {
+	typedef indices<0> type;
+};
+
+/**
+ * Character types as a constexpr table of 256 words, one per octet, built
+ * from the same sets as lexer::char_typify. Octets with the high bit set
+ * are ordinary entries, so for 8-bit char_t a lookup is a single load.
+ * Wide characters above 0xFF are string
+ */
+struct ctypetable {
+	static constexpr bool in(unsigned c, const char* s) noexcept {
+		return *s && (static_cast<unsigned char>(*s) == c || in(c, s + 1));
+	}
+	static constexpr int is(unsigned c, const char* s, ctype t) noexcept {
+		return in(c, s) ? +t : 0;
+	}
+	/** character type of octet c											*/
+	static constexpr uint16_t classify(unsigned c) noexcept {
+		return static_cast<uint16_t>(
+			is(c, "\t\n\r ",			ctype::whitespace)	|
+			is(c, "btfnru\"\\",		ctype::special)		|
+			is(c, "tfn-0123456789{[\"",	ctype::value)		|
+			is(c, "truefals",			ctype::boolean)		|
+			is(c, "nul",				ctype::null)		|
+			is(c, "0123456789",			ctype::digit)		|
+			is(c, "-+",					ctype::sign)		|
+			is(c, ".",					ctype::decimal)		|
+			is(c, "eE",					ctype::exponent)	|
+			is(c, "}],\t\n\r ",		ctype::delim)		|
+			is(c, "[,]",				ctype::array)		|
+			is(c, "{,}",				ctype::object)		|
+			is(c, "abcdef",				ctype::hex)			|
+			is(c, "ABCDEF",				ctype::heX)			|
+			(c >= ' ' ? +ctype::string : 0));
+	}
+	struct table_t {
+		uint16_t rows[256];
+		constexpr table_t() noexcept
+		  : table_t(typename make_indices<256>::type()) {}
+		template<size_t ... I>
+		constexpr table_t(indices<I...>) noexcept : rows{ classify(I)... } {}
+	};
+	static const table_t table; /* constexpr, defined in cojson.cpp		*/
+	static inline ctype lookup(char_t c) noexcept {
+		typedef typename std::make_unsigned<char_t>::type uchar_t;
+		const unsigned i = static_cast<uchar_t>(c);
+		return sizeof(char_t) == 1 || i < 256 ?
+			static_cast<ctype>(table.rows[i]) : ctype::string;
+	}
+};
+
+/** character type of c, as selected by config::chartype					*/
+static inline ctype ctypeof(char_t c) noexcept {
+	return config::chartype == config::chartype_is::inlined ?
+		ctypetable::lookup(c) : chartype(c);
+}
+
 static inline /*constexpr*/ bool isws(char_t chr) noexcept {
-	return hasbits(chartype(chr), ctype::whitespace);
+	return hasbits(ctypeof(chr), ctype::whitespace);
 }
 
+/**
+ * Number lexer - a DFA for JSON number grammar (RFC 7159 section 6).
+ * States and character classes are combined in one table of 128 words,
+ * a word per character, holding the next state for every live state in
+ * a nibble, so each character costs one table lookup. Entering a state
+ * tells the reader what to do with the character. The table is generated
+ * at compile time
+ */
+struct numlexer {
+	enum state : uint8_t {
+		start,		/* nothing read yet									*/
+		minus,		/* -												*/
+		zero,		/* -?0												*/
+		integral,	/* -?[1-9][0-9]*									*/
+		dot,		/* integral . (trailing dot is tolerated)			*/
+		fraction,	/* integral . [0-9]+								*/
+		exponent,	/* (integral|fraction) [eE]							*/
+		expsign,	/* exponent [+-]									*/
+		expdigit,	/* exponent [+-]?[0-9]+								*/
+		end,		/* delimiter after a complete number				*/
+		error		/* malformed number									*/
+	};
+	enum class cls : uint8_t {
+		other, zero, digit, minus, plus, dot, exponent, delim
+	};
+	/** character class of c, characters above 127 are other				*/
+	static constexpr cls classify(unsigned c) noexcept {
+		return	c == '0' ? cls::zero :
+				c >= '1' && c <= '9' ? cls::digit :
+				c == '-' ? cls::minus :
+				c == '+' ? cls::plus :
+				c == '.' ? cls::dot :
+				c == 'e' || c == 'E' ? cls::exponent :
+				c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+				c == ',' || c == ']' || c == '}' ? cls::delim : cls::other;
+	}
+	static constexpr bool isdigit(cls c) noexcept {
+		return c == cls::zero || c == cls::digit;
+	}
+	/** transition from state s on character class c						*/
+	static constexpr state next(state s, cls c) noexcept {
+		return
+		s == start    ? (c == cls::minus ? minus : c == cls::zero ? zero :
+						 c == cls::digit ? integral : error) :
+		s == minus    ? (c == cls::zero ? zero : c == cls::digit ? integral :
+						 error) :
+		s == zero     ? (c == cls::dot ? dot : c == cls::exponent ? exponent :
+						 c == cls::delim ? end : error) :
+		s == integral ? (isdigit(c) ? integral : c == cls::dot ? dot :
+						 c == cls::exponent ? exponent :
+						 c == cls::delim ? end : error) :
+		s == dot      ? (isdigit(c) ? fraction :
+						 c == cls::exponent ? exponent :
+						 c == cls::delim ? end : error) :
+		s == fraction ? (isdigit(c) ? fraction :
+						 c == cls::exponent ? exponent :
+						 c == cls::delim ? end : error) :
+		s == exponent ? (isdigit(c) ? expdigit :
+						 c == cls::minus || c == cls::plus ? expsign : error) :
+		s == expsign  ? (isdigit(c) ? expdigit : error) :
+		s == expdigit ? (isdigit(c) ? expdigit :
+						 c == cls::delim ? end : error) :
+		error;
+	}
+	/** returns true if a number may end in state s							*/
+	static constexpr bool complete(state s) noexcept {
+		return s == zero || s == integral || s == dot || s == fraction ||
+			   s == expdigit;
+	}
+	/** transition table, one word per character							*/
+	struct table_t {
+		uint64_t rows[128];
+		constexpr table_t() noexcept
+		  : table_t(typename make_indices<128>::type()) {}
+		template<size_t ... I>
+		constexpr table_t(indices<I...>) noexcept : rows{ row(I)... } {}
+	};
+	/** next states of live states from s on, on character c				*/
+	static constexpr uint64_t row(unsigned c, unsigned s = start) noexcept {
+		return s < end ? (static_cast<uint64_t>(next(static_cast<state>(s),
+			classify(c))) << (s * 4)) | row(c, s + 1) : 0;
+	}
+	static const table_t table; /* constexpr, defined in cojson.cpp		*/
+	/** transition from state s on character c								*/
+	static inline state step(state s, char_t c) noexcept {
+		typedef typename std::make_unsigned<char_t>::type uchar_t;
+		const uchar_t i = static_cast<uchar_t>(c);
+		return i < 128 ?
+			static_cast<state>((table.rows[i] >> (s * 4)) & 0xF) : error;
+	}
+};
+
+/**
+ * Memo of the last short number token and its value. Tokens of up to
+ * 8 bytes are packed into a word while being lexed, a token that repeats
+ * the previous one is consumed without conversion
+ */
+struct numbermemo {
+	static constexpr size_t maxlen = 8 / sizeof(char_t);
+	inline numbermemo() noexcept
+	  : word(0), next(0), len(0), pending(0), key(0), value{} {}
+	/** starts a new token												*/
+	inline void start() noexcept {
+		next = 0;
+		pending = 0;
+	}
+	/** appends a character to the token being lexed						*/
+	inline void push(char_t c) noexcept {
+		if( pending > maxlen ) return;
+		next = append(next, c);
+		++pending;
+	}
+	/** if the token starting at t repeats the memorized one, consumes it
+	 *  from the stream and returns true									*/
+	template<typename T>
+	inline bool recall(T& val, const char_t* t, istream& in) noexcept {
+		if( len == 0 || key != keyof<T>() ||
+			t[0] != static_cast<char_t>(word >> (bits * (len - 1))) )
+			return false;
+		const size_t n = in.ahead(len);
+		if( n + 1 < len ) return false;
+		uint64_t w = 0;
+		for(size_t i = 0; i < len; ++i) w = append(w, t[i]);
+		if( w != word ) return false;
+		const bool ends = n == len;
+		if( ends && numlexer::classify(static_cast<uchar_t>(t[len])) !=
+				numlexer::cls::delim ) return false;
+		char_t chr;
+		for(size_t i = 1; i < len; ++i) in.get(chr);
+		/* whitespace after the token and end of stream are consumed as
+		 * the reader does, other delimiters are left in the stream		*/
+		if( ! ends || isws(t[len]) ) in.get(chr);
+		val = std::is_floating_point<T>::value ?
+			static_cast<T>(value.d) : static_cast<T>(value.i);
+		return true;
+	}
+	/** memorizes the token just lexed and its value						*/
+	template<typename T>
+	inline void remember(const T& val) noexcept {
+		if( pending > maxlen ) {
+			len = 0;
+			return;
+		}
+		word = next;
+		len = pending;
+		key = keyof<T>();
+		if( std::is_floating_point<T>::value )
+			value.d = static_cast<double>(val);
+		else
+			value.i = static_cast<uintmax_t>(val);
+	}
+private:
+	typedef typename std::make_unsigned<char_t>::type uchar_t;
+	static constexpr unsigned bits = 8 * sizeof(char_t);
+	static inline uint64_t append(uint64_t w, char_t c) noexcept {
+		return (w << bits) | static_cast<uchar_t>(c);
+	}
+	template<typename T>
+	static constexpr uint_fast8_t keyof() noexcept {
+		return sizeof(T) | (std::is_signed<T>::value ? 0x40 : 0) |
+			(std::is_floating_point<T>::value ? 0x80 : 0);
+	}
+	uint64_t word;
+	uint64_t next;
+	uint_fast8_t len;
+	uint_fast8_t pending;
+	uint_fast8_t key;
+	union {
+		uintmax_t i;
+		double d;
+	} value;
+};
+
+/** stub for config::number_memo_is::none								*/
+struct nonumbermemo {
+	inline void start() noexcept {}
+	inline void push(char_t) noexcept {}
+	template<typename T>
+	inline bool recall(T&, const char_t*, istream&) noexcept {
+		return false;
+	}
+	template<typename T>
+	inline void remember(const T&) noexcept {}
+};
+
 /**
  * Lexer/scanner
  */
 struct lexer : noncopyable {
-	inline lexer(istream& in) noexcept : stream(in), hold(0) {}
+	/** input validation mode											*/
+	enum class input {
+		checked,	/** input is fully validated						*/
+		trusted		/** input is assumed well-formed, e.g. produced by
+		cojson itself. Stream errors, literals and number grammar are
+		not checked, integers are not checked for overflow				*/
+	};
+	inline lexer(istream& in, arena* mem = nullptr,
+			input mode = input::checked) noexcept
+	  : stream(in), scratch(mem), hold(0), trust(mode == input::trusted),
+		line(false), records(false) {}
 
 	static inline void char_typify(
 		void (*add)(const char * str,ctype traits)noexcept) noexcept {
@@ -717,6 +1143,11 @@ struct lexer : noncopyable {
 		return isvalid(skip(dst, ctype::whitespace));
 	}
 
+	/** reads next character of a number and returns the next state of
+	 *  numlexer, at end of stream returns end for a complete number with
+	 *  chr set to iostate::eos_c											*/
+	numlexer::state number(char_t& chr, numlexer::state st) noexcept;
+
 	/** reads member, returns ctype::cstring on success						*/
 	bool member(char_t*& l) noexcept;
 	/** skips one or more elements, returns true on success */
@@ -740,7 +1171,10 @@ struct lexer : noncopyable {
 	}
 
 	inline ctype bad(char_t c) noexcept {
-		return iostate::isok(c) ? bad() : eos2eof(c);
+		if( ! iostate::isok(c) ) return eos2eof(c);
+		/* after a newline c may begin the next record, keep it for next() */
+		if( line && records ) hold = c;
+		return bad();
 	}
 
 	static constexpr inline ctype eos2eof(char_t c) noexcept {
@@ -759,6 +1193,65 @@ struct lexer : noncopyable {
 		return chr == literal_strings<char_t>::null_l()[0];
 	}
 
+	/** prepares for the next top-level value in the same stream (NDJSON):
+	 *  clears errors of the previous value, skips remainder of the line
+	 *  if reading the value was blocked by an error before its line ended,
+	 *  and skips whitespace. From then on a character that fails a value
+	 *  after a newline is kept as the possible start of the next record.
+	 *  Returns false at end of stream or on I/O error						*/
+	bool next() noexcept;
+
+	/** sets input validation mode for the next read					*/
+	inline void assume(input mode) noexcept {
+		trust = mode == input::trusted;
+	}
+	inline bool trusted() const noexcept { return trust; }
+
+	/** returns next character with no checks, for trusted input only	*/
+	inline char_t raw() noexcept {
+		char_t chr;
+		if( hold ) {
+			chr = hold;
+			hold = 0;
+		} else
+			stream.get(chr);
+		return chr;
+	}
+
+	/** scratch memory attached to this lexer, may be nullptr				*/
+	inline arena* memory() const noexcept { return scratch; }
+
+	/** returns pointer to the next unread character in a contiguous input
+	 *  or nullptr if input is not contiguous or a character is held back	*/
+	inline const char_t* head() const noexcept {
+		return hold ? nullptr : stream.head();
+	}
+
+	/** marks start of the number token just checked by value(), returns
+	 *  its position on a contiguous input or nullptr						*/
+	inline const char_t* mark() noexcept {
+		if( config::number_memo == config::number_memo_is::none || ! hold )
+			return nullptr;
+		const char_t* h = stream.head();
+		if( h == nullptr ) return nullptr;
+		memo.start();
+		return h - 1;
+	}
+	/** if the number token at begin repeats the previous short token,
+	 *  consumes it and returns true with its value in val					*/
+	template<typename T>
+	inline bool recall(T& val, const char_t* begin) noexcept {
+		if( begin == nullptr || ! memo.recall(val, begin, stream) )
+			return false;
+		hold = 0; /* the first character, consumed by value()			*/
+		return true;
+	}
+	/** memorizes the number token marked at begin and its value			*/
+	template<typename T>
+	inline void remember(const T& val, const char_t* begin) noexcept {
+		if( begin != nullptr ) memo.remember(val);
+	}
+
 private:
 	ctype unescape(char_t& chr ) noexcept;
 	ctype unhex(char_t& chr) noexcept;
@@ -775,10 +1268,93 @@ private:
 private:
 	using cfg = configuration::Configuration<lexer>;
 	istream& stream;
+	arena* const scratch;
 	temporary_s<char_t, cfg::temporary_size, cfg::temporary_static> name;
 	char_t hold;
+	bool trust;
+	bool line; /* a newline was read since the value started			*/
+	bool records; /* reading NDJSON records, next() was called			*/
+	typename std::conditional<
+		config::number_memo == config::number_memo_is::previous,
+		numbermemo, nonumbermemo>::type memo;
 };
 
+/**
+ * Validator - checks that a text is a single well-formed JSON value,
+ * strings are checked for valid UTF-8 when char_t is char.
+ * The text may be fed in chunks of any size, memory use is constant,
+ * nesting is limited to maxdepth levels
+ */
+class validator {
+public:
+	static constexpr size_t maxdepth = 128;
+	inline validator() noexcept
+	  : pos(0), depth(0), st(state::value), aux(0), need(0), lo(0), hi(0),
+		lit(nullptr), nest{} {}
+	/** validates the next chunk of text, returns false on the first error,
+	 *  which is then located by offset()								*/
+	bool feed(const char_t* text, size_t n) noexcept;
+	/** returns true if the text fed so far is complete					*/
+	bool finish() noexcept;
+	/** count of characters accepted so far							*/
+	inline size_t offset() const noexcept { return pos; }
+private:
+	enum class state : uint8_t {
+		value,		/* a value is expected								*/
+		first,		/* a value or ] is expected							*/
+		member,		/* a key is expected								*/
+		firstmember,/* a key or } is expected							*/
+		colon,		/* name separator is expected						*/
+		next,		/* value separator or end of array/object			*/
+		string,		/* inside a string, aux is 1 for keys				*/
+		escape,		/* after reverse solidus							*/
+		hex,		/* inside \u escape, aux counts remaining digits	*/
+		utf8,		/* inside a UTF-8 sequence							*/
+		number,		/* inside a number, aux is the numlexer state		*/
+		literal,	/* inside true, false or null						*/
+		failed
+	};
+	bool step(char_t c) noexcept;
+	bool open(bool object) noexcept;
+	bool close(bool object) noexcept;
+	size_t pos;
+	size_t depth;
+	state st;
+	uint8_t aux;		/* state dependent data							*/
+	uint8_t need;		/* continuation octets left in UTF-8 sequence	*/
+	uint8_t lo, hi;		/* range of the next continuation octet			*/
+	const char* lit;	/* remainder of the literal being matched		*/
+	uint8_t nest[maxdepth / 8]; /* 1 bit per level, set for objects		*/
+};
+
+/**
+ * Validates a contiguous text of n characters. On failure offset,
+ * if not null, receives the position of the offending character
+ */
+bool validate(const char_t* text, size_t n, size_t* offset = nullptr) noexcept;
+
+/**
+ * Validates a text read from stream in, stream errors fail validation
+ */
+bool validate(istream& in, size_t* offset = nullptr) noexcept;
+
+/**
+ * Rewrites one JSON value from in to out in compact canonical form:
+ * no insignificant whitespace, strings with the shortest escapes and
+ * \u escapes decoded, numbers without redundant signs, zeros and
+ * exponents. Output is staged and written with putn. Nesting is limited
+ * to 32 levels. Malformed input sets error_t::bad and stops the output
+ */
+bool minify(lexer& in, ostream& out) noexcept;
+
+/**
+ * Same as minify, and members of objects that fit the window entirely
+ * and have at most 16 members are sorted by key. Larger objects keep
+ * the input order
+ */
+bool canonicalize(lexer& in, ostream& out, char_t* window, size_t size)
+	noexcept;
+
 /******************************************************************************/
 /* multiplication by 10 with saturation on overflow */
 template<typename T>
@@ -828,6 +1404,10 @@ struct reader<T,false> {
 	 * if it can read only part of the value it skips the remainder
 	 */
 	static bool read(T& val, lexer& in) noexcept {
+		if( in.trusted() )
+			return assume(val, in);
+		if( config::number_lexer == config::number_lexer_is::table )
+			return scan(val, in);
 		/* routing read of types shorter than int to reader<int>
 		 * could save ~50 bytes per type on avr, if overflow control is not set.
 		 * decision is made to keep type-specific reads
@@ -870,6 +1450,58 @@ struct reader<T,false> {
 		};
 		return true;
 	}
+
+	/** reads value from trusted input, digits are not validated */
+	static bool assume(T& val, lexer& in) noexcept {
+		if( ! isvalid(in.value(ctype::numeric)) ) return false;
+		char_t chr = in.raw();
+		const bool neg = chr == literal::minus;
+		if( neg ) chr = in.raw();
+		T v = 0;
+		for(unsigned d; (d = static_cast<unsigned>(chr - literal::digit0)) < 10;
+				chr = in.raw())
+			v = v * 10 + (neg ? -static_cast<T>(d) : static_cast<T>(d));
+		val = v;
+		if( chr != iostate::eos_c && ! isws(chr) ) in.back(chr);
+		return true;
+	}
+
+	/** reads value with the numlexer transition table */
+	static bool scan(T& val, lexer& in) noexcept {
+		char_t chr = 0;
+		bool neg = false;
+		val = 0;
+		if( ! isvalid(in.value(ctype::numeric)) ) return false;
+		const char_t* token = in.mark();
+		if( in.recall(val, token) ) return true;
+		numlexer::state st = numlexer::start;
+		while(true) switch( st = in.number(chr, st) ) {
+		case numlexer::zero:
+			continue;
+		case numlexer::integral:
+			if( tenfold<T>(val, static_cast<T>(neg ?
+					literal::digit0 - chr : chr - literal::digit0)) ) continue;
+			in.error(error_t::overflow);
+			return in.skip(ctype::number);
+		case numlexer::minus:
+			if( std::is_signed<T>::value ) {
+				neg = true;
+				continue;
+			}
+			/* no break */
+		case numlexer::dot:
+		case numlexer::exponent:
+			in.error(error_t::mismatch);
+			return false;
+		case numlexer::end:
+			in.remember(val, token);
+			if( chr != iostate::eos_c && ! isws(chr) ) in.back(chr);
+			return true;
+		default:
+			if( chr != iostate::err_c ) in.error(error_t::bad);
+			return false;
+		}
+	}
 };
 
 template<>
@@ -978,6 +1610,11 @@ struct writer<char_t*> {
 template<>
 struct writer<double> {
 	static bool write(const double& val, ostream& out) noexcept;
+	/** writes val with given number of significant digits				*/
+	static bool write(const double& val, ostream& out,
+		unsigned precision) noexcept;
+	/** writes val with fewest significant digits that read back as val	*/
+	static bool shortest(const double& val, ostream& out) noexcept;
 };
 
 template<>
@@ -994,6 +1631,189 @@ struct writer<bool> {
 	}
 };
 
+/**
+ * Fixed-point decimal numbers, integer arithmetic only
+ */
+namespace decimals {
+template<typename U>
+static constexpr U pow10(unsigned n) noexcept {
+	return n ? 10 * pow10<U>(n - 1) : 1;
+}
+
+/**
+ * reads a JSON number as magnitude mag scaled by 10^frac, rounding half
+ * away from zero. Returns false on malformed input, leaves overflow
+ * checks to the caller
+ */
+template<typename U>
+bool read(U& mag, bool& neg, unsigned frac, lexer& in) noexcept {
+	static constexpr U limit = (std::numeric_limits<U>::max() - 9) / 10;
+	static constexpr int maxexp = 999;
+	static constexpr unsigned maxpow = std::numeric_limits<U>::digits10;
+	U acc = 0;
+	int shift = 0;		/* decimal exponent of acc						*/
+	int exp = 0;
+	bool expneg = false;
+	char_t chr;
+	ctype ct;
+	neg = false;
+	if( ! isvalid(in.value(ctype::numeric)) ) return false;
+	numlexer::state st = numlexer::start;
+	do {
+		if( config::number_lexer == config::number_lexer_is::table ) {
+			st = in.number(chr, st);
+			ct = chr == iostate::eos_c ? ctype::eof : ctype::number;
+		} else {
+			/* classified by comparisons, saves the 1K table on AVR */
+			ct = in.get(chr, ctype::number);
+			if( ct < ctype::unknown && ct != ctype::eof ) return false;
+			st = numlexer::next(st, ct == ctype::eof ? numlexer::cls::delim
+				: numlexer::classify(static_cast<unsigned>(chr)));
+		}
+		const unsigned digit = static_cast<unsigned>(chr - literal::digit0);
+		switch( st ) {
+		case numlexer::minus:
+			neg = true;
+			break;
+		case numlexer::integral:
+			if( acc <= limit ) acc = acc * 10 + digit;
+			else ++shift;
+			break;
+		case numlexer::fraction:
+			if( acc <= limit ) {
+				acc = acc * 10 + digit;
+				--shift;
+			}
+			break;
+		case numlexer::expsign:
+			expneg = chr == literal::minus;
+			break;
+		case numlexer::expdigit:
+			if( exp < maxexp ) exp = exp * 10 + digit;
+			break;
+		case numlexer::error:
+			if( chr != iostate::err_c ) in.error(error_t::bad);
+			return false;
+		default:
+			break;
+		}
+	} while( st != numlexer::end );
+	if( ct != ctype::eof && ! isws(chr) ) in.back(chr);
+	shift += (expneg ? -exp : exp) + static_cast<int>(frac);
+	if( acc == 0 ) {
+		mag = 0;
+		return true;
+	}
+	if( shift >= 0 ) {
+		for(; shift > 0; --shift) {
+			if( acc > std::numeric_limits<U>::max() / 10 ) {
+				mag = std::numeric_limits<U>::max();
+				return true;
+			}
+			acc *= 10;
+		}
+		mag = acc;
+		return true;
+	}
+	if( static_cast<unsigned>(-shift) > maxpow ) {
+		mag = 0;
+		return true;
+	}
+	const U p = pow10<U>(-shift);
+	mag = acc / p + (acc % p >= p / 2 ? 1 : 0);
+	return true;
+}
+
+/** writes magnitude mag scaled by 10^frac								*/
+template<typename U>
+bool write(U mag, bool neg, unsigned frac, ostream& out) noexcept {
+	const U scale = pow10<U>(frac);
+	if( ! write_number<U>(mag / scale, neg && mag, pow10<U>(
+			std::numeric_limits<U>::digits10), out) )
+		return false;
+	if( frac == 0 ) return true;
+	if( ! out.put(literal::decimal) ) return false;
+	mag %= scale;
+	for(U d = scale / 10; d; d /= 10)
+		if( ! out.put(literal::digit0 + static_cast<char_t>((mag / d) % 10)) )
+			return false;
+	return true;
+}
+}
+
+/**
+ * Number format policies, selected per property or value at declaration.
+ * A policy reads and writes values of a numeric type T
+ */
+namespace format {
+/** format per configuration, write_double_precision for doubles		*/
+struct standard {
+	template<typename T>
+	static inline bool read(T& val, lexer& in) noexcept {
+		return reader<T>::read(val, in);
+	}
+	template<typename T>
+	static inline bool write(const T& val, ostream& out) noexcept {
+		return writer<T>::write(val, out);
+	}
+};
+
+/** N digits after the decimal point, rounded half away from zero.
+ *  Values beyond 64-bit range are written per configuration			*/
+template<unsigned N>
+struct fixed : standard {
+	static_assert(N <= 18, "Unsupported number of decimals");
+	typedef uint64_t U;
+	template<typename T>
+	static bool write(const T& val, ostream& out) noexcept {
+		const double mag = (val < 0 ? -val : val) *
+			decimals::pow10<U>(N) + 0.5;
+		if( ! (mag < static_cast<double>(std::numeric_limits<U>::max())) )
+			return writer<double>::write(val, out);
+		return decimals::write<U>(static_cast<U>(mag), val < 0, N, out);
+	}
+};
+
+/** N significant digits													*/
+template<unsigned N>
+struct significant : standard {
+	template<typename T>
+	static inline bool write(const T& val, ostream& out) noexcept {
+		return writer<double>::write(val, out, N);
+	}
+};
+
+/** fewest significant digits that read back to the same value			*/
+struct shortest : standard {
+	template<typename T>
+	static inline bool write(const T& val, ostream& out) noexcept {
+		return writer<double>::shortest(val, out);
+	}
+};
+
+/** integer number val * S, e.g. S=100 writes 21.37 as 2137				*/
+template<long S>
+struct scaled {
+	static_assert(S > 0, "Scale must be positive");
+	template<typename T>
+	static bool read(T& val, lexer& in) noexcept {
+		double tmp;
+		if( ! reader<double>::read(tmp, in) ) return false;
+		val = tmp / S;
+		return true;
+	}
+	template<typename T>
+	static bool write(const T& val, ostream& out) noexcept {
+		const double v = val * S;
+		if( ! (v > std::numeric_limits<long>::min() &&
+			   v < std::numeric_limits<long>::max()) )
+			return writer<double>::write(v, out);
+		return writer<long>::write(static_cast<long>(v < 0 ? v-0.5 : v+0.5),
+			out);
+	}
+};
+}
+
 /**
  * helper for getting array extent
  */
@@ -1021,10 +1841,34 @@ static inline bool compare(const T (&a)[N], const T (&v)[N]) noexcept  {
 	return true;
 }
 
+/**
+ * string_view - a non-owning reference to a string.
+ * When read from a contiguous input (see istream::head) an escape-free
+ * string is referenced in place, a string with escapes is unescaped into
+ * the lexer's scratch arena. Referenced data lives as long as the input
+ * buffer and the arena. Plugs into P<> and V<> as a regular scalar type
+ */
+struct string_view {
+	inline constexpr string_view() noexcept : ptr(nullptr), len(0) {}
+	inline constexpr string_view(const char_t* s, size_t n) noexcept
+	  : ptr(s), len(n) {}
+	inline const char_t* data() const noexcept { return ptr; }
+	inline size_t size() const noexcept { return len; }
+	inline bool empty() const noexcept { return len == 0; }
+	inline char_t operator[](size_t i) const noexcept { return ptr[i]; }
+	bool read(lexer&) noexcept;
+	bool write(ostream&) const noexcept;
+private:
+	const char_t* ptr;
+	size_t len;
+};
+
 
 } /* namespace details */
 using lexer = details::lexer;
 using cstring = details::cstring;
+using arena = details::arena;
+using string_view = details::string_view;
 
 namespace details {
 /**
@@ -1121,8 +1965,9 @@ struct collection {
 			if( ! id.prolog(in) ) return false;
 			if( s.read(dst, in, id++) ) continue;
 			if( in.skip(I::skiplist) ) continue;
-			/* no break */
+			return false;
 		default:
+			in.bad(chr);
 			return false;
 		} while( isvalid(ct=in.skip(chr, ctype::whitespace))
 				&& isvalid(andmask(ct, I::middle)) );
@@ -1203,6 +2048,8 @@ private:
 	virtual cstring name() const noexcept = 0;
 	virtual bool readval(lexer&) const noexcept = 0;
 	virtual bool writeval(ostream&) const noexcept = 0;
+	/** should return false if the member has no value to write */
+	virtual bool has() const noexcept { return true; }
 
 	static inline bool prolog(cstring name, ostream& out) noexcept {
 		return writer<cstring>::write(name, out)
@@ -1239,6 +2086,82 @@ private:
 	const size_t size;
 };
 
+/**
+ * presence - a set of object members, by member index.
+ * After reading it tells members present in the input,
+ * on writing it selects members to output
+ */
+class presence : noncopyable {
+public:
+	inline bool test(size_t i) const noexcept {
+		return i < size && (bits[i >> 3] & (1 << (i & 7)));
+	}
+	inline void set(size_t i) noexcept {
+		if( i < size ) bits[i >> 3] |= (1 << (i & 7));
+	}
+	inline void reset(size_t i) noexcept {
+		if( i < size ) bits[i >> 3] &= ~(1 << (i & 7));
+	}
+	/** marks all members absent */
+	inline void clear() noexcept {
+		for(size_t i = 0; i < (size + 7) >> 3; ++i) bits[i] = 0;
+	}
+	/** marks all members present */
+	inline void fill() noexcept {
+		for(size_t i = 0; i < (size + 7) >> 3; ++i) bits[i] = 0xFF;
+	}
+protected:
+	inline presence(unsigned char* b, size_t n) noexcept
+	  : bits(b), size(n) {}
+private:
+	unsigned char* const bits;
+	const size_t size;
+};
+
+/**
+ * bitmap - presence of up to N members
+ */
+template<size_t N>
+class bitmap : public presence {
+public:
+	inline bitmap() noexcept : presence(data, N), data{} {}
+private:
+	unsigned char data[(N + 7) / 8];
+};
+
+/**
+ * trail - order of members in the last object read, by key position.
+ * Readers of arrays keep one trail across the elements, so that elements
+ * listing their keys in the same order as the previous one resolve each
+ * key with a single match. Keys past the capacity, and all keys of the
+ * first object, are predicted in the declaration order
+ */
+class trail : noncopyable {
+public:
+	static constexpr size_t capacity = 8;
+	inline trail() noexcept : order{}, known(0), pos(0), next(0) {}
+	/** starts a new object, the order of the last one becomes prediction */
+	inline void start() noexcept {
+		known = pos < capacity ? pos : capacity;
+		pos = next = 0;
+	}
+	/** index of the member predicted at the current key position */
+	inline size_t predict() const noexcept {
+		return pos < known ? order[pos] : next;
+	}
+	/** records member i matched at the current key position */
+	inline void matched(size_t i) noexcept {
+		if( pos < capacity ) order[pos] = static_cast<unsigned char>(i);
+		++pos;
+		next = i + 1;
+	}
+private:
+	unsigned char order[capacity];
+	size_t known;
+	size_t pos;
+	size_t next;
+};
+
 /**
  * property - a named property of c++ class or structure
  */
@@ -1251,6 +2174,8 @@ struct property : noncopyable {
 	virtual cstring name() const noexcept = 0;
 	virtual bool read(C& obj, lexer&) const noexcept = 0;
 	virtual bool write(const C& obj, ostream&) const noexcept = 0;
+	/** should return false if the property has no value to write */
+	virtual bool has(const C&) const noexcept { return true; }
 	inline bool match(const char_t* aname) const noexcept {
 		return details::match(name(),aname);
 	}
@@ -1267,17 +2192,26 @@ struct clas : noncopyable {
 	typedef typename property<C>::node node;
 	clas(const node * n, size_t s) noexcept : nodes(n), size(s) { }
 	bool read(C& obj, lexer& in) const noexcept {
-		return collection<indexer>::read(*this, obj, in);
+		trail order;
+		return read(obj, in, order);
+	}
+	/** reads obj predicting its members in the order kept in the trail */
+	bool read(C& obj, lexer& in, trail& order) const noexcept {
+		order.start();
+		return collection<indexer>::read(predictor { *this, order }, obj, in);
+	}
+	/** reads obj and marks in set the members read from the input */
+	bool read(C& obj, lexer& in, presence& set) const noexcept {
+		trail order;
+		set.clear();
+		return collection<indexer>::read(marker { *this, set, order }, obj, in);
 	}
 	bool write(const C& obj, ostream& out) const noexcept {
-		bool r = true;
-		for(size_t i = 0; i < size && r; ++i) {
-			const property<C>& prop(nodes[i]());
-			r = object::dlm(i==0, out) 			&&
-				member::prolog(prop.name(), out)&&
-				prop.write(obj, out);
-		}
-		return r && object::end(out);
+		return write(obj, out, nullptr);
+	}
+	/** writes only members marked in set */
+	bool write(const C& obj, ostream& out, const presence& set) const noexcept {
+		return write(obj, out, &set);
 	}
 	static inline constexpr bool null(C&) noexcept {
 		return config::null_is_error;
@@ -1285,35 +2219,355 @@ struct clas : noncopyable {
 protected:
 	friend class collection<indexer>;
 	inline bool read(C& obj, lexer& in, const char_t * name) const noexcept {
-		for(size_t i = 0; i < size; ++i) {
-			const property<C>& m(nodes[i]());
-			if( m.match(name) ) {
-				m.read(obj, in);
-				return true;
-			}
+		const size_t i = find(name);
+		if( i < size ) {
+			nodes[i]().read(obj, in);
+			return true;
 		}
 		return false;
 	}
+	/** returns index of the property by name, or size if not found */
+	inline size_t find(const char_t * name) const noexcept {
+		size_t i = 0;
+		while( i < size && ! nodes[i]().match(name) ) ++i;
+		return i;
+	}
+	/** returns index of the property by name, trying the predicted first
+	 *  and recording the match in the trail */
+	inline size_t find(const char_t * name, trail& order) const noexcept {
+		const size_t p = order.predict();
+		const size_t i = p < size && nodes[p]().match(name) ? p : find(name);
+		if( i < size ) order.matched(i);
+		return i;
+	}
 	const node * nodes;
 	const size_t size;
+private:
+	/** structural object predicting the next member to be read	*/
+	struct predictor {
+		const clas& s;
+		trail& order;
+		static inline constexpr bool null(C& obj) noexcept {
+			return clas::null(obj);
+		}
+		inline bool read(C& obj, lexer& in, const char_t * name) const noexcept {
+			const size_t i = s.find(name, order);
+			if( i < s.size ) {
+				s.nodes[i]().read(obj, in);
+				return true;
+			}
+			return false;
+		}
+	};
+	/** structural object marking members being read */
+	struct marker {
+		const clas& s;
+		presence& set;
+		trail& order;
+		static inline constexpr bool null(C& obj) noexcept {
+			return clas::null(obj);
+		}
+		inline bool read(C& obj, lexer& in, const char_t * name) const noexcept {
+			const size_t i = s.find(name, order);
+			if( i < s.size ) {
+				if( s.nodes[i]().read(obj, in) ) set.set(i);
+				return true;
+			}
+			return false;
+		}
+	};
+	bool write(const C& obj, ostream& out, const presence* set) const noexcept {
+		bool r = true, first = true;
+		for(size_t i = 0; i < size && r; ++i) {
+			const property<C>& prop(nodes[i]());
+			if( set != nullptr && ! set->test(i) ) continue;
+			if( config::absent_omitted && ! prop.has(obj) ) continue;
+			r = object::dlm(first, out) 		&&
+				member::prolog(prop.name(), out)&&
+				prop.write(obj, out);
+			first = false;
+		}
+		return r && (! first || object::dlm(true, out)) && object::end(out);
+	}
+};
+
+/**
+ * FNV-1a hash of a key, accumulated as the key characters stream in
+ */
+struct keyhash {
+	static constexpr uint32_t basis = 2166136261u;
+	static constexpr uint32_t prime = 16777619u;
+	inline void add(char_t chr) noexcept {
+		h = (h ^ static_cast<typename std::make_unsigned<char_t>::type>(chr))
+				* prime;
+	}
+	static inline uint32_t of(const char_t* key) noexcept {
+		keyhash k;
+		while( *key ) k.add(*key++);
+		return k.h;
+	}
+	uint32_t h = basis;
+};
+
+/**
+ * Object members iterator for reading keys not known in advance
+ */
+struct keyiterator : iterator {
+	static constexpr auto start = ctype::objectnull;
+	static constexpr auto finish = literal::end_object;
+	static constexpr auto middle = ctype::object;
+	static constexpr bool skiplist = false;
+};
+
+/**
+ * hashmap - JSON object with dynamic keys, mapped to an open-addressing
+ * hash table with linear probing. Entries are kept in insertion order and
+ * written in that order. Keys are hashed while they are read, directly
+ * into the storage. Reading replaces the content, null clears it.
+ * S - storage, provides entries, the slot index and the staging key.
+ * See fixedmap for the storage interface
+ */
+template<class S>
+class hashmap : public S {
+public:
+	typedef typename S::value_type T;
+	using S::count;
+	using S::key;
+
+	/** returns pointer to the value by key or nullptr if key is absent */
+	T* find(const char_t* k) noexcept {
+		size_t i = lookup(keyhash::of(k), k);
+		return S::slot(i) ? &S::value(S::slot(i)-1) : nullptr;
+	}
+	inline const T* find(const char_t* k) const noexcept {
+		return const_cast<hashmap*>(this)->find(k);
+	}
+	inline T& value(size_t i) noexcept { return S::value(i); }
+	inline const T& value(size_t i) const noexcept {
+		return const_cast<hashmap*>(this)->S::value(i);
+	}
+
+	/** returns value for the key, inserting it if absent
+	 *  or nullptr if the key does not fit or the storage is full */
+	T* insert(const char_t* k) noexcept {
+		keyhash h;
+		size_t n = 0;
+		for(; k[n]; ++n) {
+			h.add(k[n]);
+			if( ! S::stage(n, k[n]) ) return nullptr;
+		}
+		return S::stage(n, 0) ? insert(h.h) : nullptr;
+	}
+
+	void clear() noexcept {
+		for(size_t i = 0; i < S::slots(); ++i) S::slot(i) = 0;
+		S::clear();
+	}
+
+	bool read(lexer& in) noexcept {
+		clear();
+		return collection<keyiterator>::read(structure(), *this, in);
+	}
+
+	bool write(ostream& out) const noexcept {
+		bool r = true;
+		for(size_t i = 0; i < count() && r; ++i) {
+			r = object::dlm(i==0, out) &&
+				writer<const char_t*>::write(key(i), out) &&
+				out.put(literal::name_separator) &&
+				writer<T>::write(value(i), out);
+		}
+		return r && (count() || object::dlm(true, out)) && object::end(out);
+	}
+
+private:
+	/** returns slot position holding key k or first vacant slot */
+	size_t lookup(uint32_t h, const char_t* k) const noexcept {
+		const size_t mask = S::slots() - 1;
+		size_t i = h & mask;
+		for(size_t e; (e = S::slot(i)) != 0; i = (i + 1) & mask) {
+			if( S::hash(e-1) == h && match(key(e-1), k) ) break;
+		}
+		return i;
+	}
+
+	/** inserts staged key with hash h unless it is present */
+	T* insert(uint32_t h) noexcept {
+		size_t i = lookup(h, S::staged());
+		if( S::slot(i) ) return &S::value(S::slot(i)-1);
+		if( S::crowded() ) {
+			if( ! S::grow() ) return nullptr;
+			reindex();
+			i = lookup(h, S::staged());
+		}
+		S::slot(i) = S::append(h) + 1;
+		return &S::value(count()-1);
+	}
+
+	/** rebuilds the slot index after the storage grew */
+	void reindex() noexcept {
+		const size_t mask = S::slots() - 1;
+		for(size_t i = 0; i < S::slots(); ++i) S::slot(i) = 0;
+		for(size_t e = 0; e < count(); ++e) {
+			size_t i = S::hash(e) & mask;
+			while( S::slot(i) ) i = (i + 1) & mask;
+			S::slot(i) = e + 1;
+		}
+	}
+
+	/** reads "key":value pairs, accumulating key hash on the fly */
+	struct structure {
+		static inline bool null(hashmap&) noexcept { return true; }
+		bool read(hashmap& map, lexer& in, size_t) const noexcept {
+			keyhash h;
+			ctype ct;
+			char_t chr;
+			size_t n = 0;
+			bool fits = true;
+			if( ! in.skipws(chr) || chr != literal::quotation_mark ) {
+				in.error(error_t::bad);
+				return false;
+			}
+			in.back(chr);
+			for(bool first = true;
+					(ct=in.string(chr, first)) == ctype::string; first = false) {
+				h.add(chr);
+				fits = fits && map.stage(n++, chr);
+			}
+			if( ct != ctype::delim || ! in.skipws(chr) ||
+					chr != literal::name_separator ) {
+				in.error(error_t::bad);
+				return false;
+			}
+			T* val = fits && map.stage(n, 0) ? map.insert(h.h) : nullptr;
+			if( val == nullptr ) {
+				in.error(error_t::overrun);
+				return in.skip();
+			}
+			return reader<T>::read(*val, in);
+		}
+	};
+};
+
+/**
+ * fixed capacity storage for hashmap, no dynamic memory
+ * T - value type
+ * N - max number of entries
+ * K - key buffer size, including terminating zero
+ */
+template<typename T, size_t N, size_t K>
+class fixedmap {
+public:
+	typedef T value_type;
+	inline size_t count() const noexcept { return used; }
+	inline const char_t* key(size_t i) const noexcept {
+		return entries[i].key;
+	}
+protected:
+	typedef typename std::conditional<(N < 255), uint8_t,
+			typename std::conditional<(N < 65535),
+				uint16_t, size_t>::type>::type index_t;
+	/* keeps load factor under 3/4 */
+	static constexpr size_t pow2(size_t n, size_t p = 1) noexcept {
+		return p >= n ? p : pow2(n, p << 1);
+	}
+	static constexpr size_t size = pow2(N + N / 3 + 1);
+
+	inline T& value(size_t i) noexcept { return entries[i].value; }
+	inline uint32_t hash(size_t i) const noexcept { return entries[i].hash; }
+	inline static constexpr size_t slots() noexcept { return size; }
+	inline index_t& slot(size_t i) noexcept { return index[i]; }
+	inline index_t slot(size_t i) const noexcept { return index[i]; }
+	/** stores n-th character of the incoming key, 0 terminates the key */
+	inline bool stage(size_t n, char_t chr) noexcept {
+		if( n >= K ) return false;
+		(used < N ? entries[used].key : spare)[n] = chr;
+		return true;
+	}
+	inline const char_t* staged() const noexcept {
+		return used < N ? entries[used].key : spare;
+	}
+	inline bool crowded() const noexcept { return used >= N; }
+	static inline constexpr bool grow() noexcept { return false; }
+	/** appends staged key as a new entry, returns its index.
+	 *  The value is reset, a failed read must not expose a stale one	*/
+	inline size_t append(uint32_t h) noexcept {
+		entries[used].value = T {};
+		entries[used].hash = h;
+		return used++;
+	}
+	inline void clear() noexcept { used = 0; }
+private:
+	struct entry {
+		T value;
+		uint32_t hash;
+		char_t key[K];
+	};
+	entry entries[N] {};
+	char_t spare[K] {};
+	index_t index[size] {};
+	size_t used = 0;
+};
+
+/**
+ * dictionary - JSON object with up to N dynamic keys of up to K-1 chars
+ * mapped to values of type T
+ */
+template<typename T, size_t N, size_t K>
+using dictionary = hashmap<fixedmap<T,N,K>>;
+
+/**
+ * NDJSON record writer - writes values to out one per line and flushes
+ * out after every maxrecords records or maxbytes bytes, whichever comes
+ * first. Zero disables the limit, nullptr flusher makes flush a no-op
+ */
+class recordwriter : public ostream {
+public:
+	typedef bool (*flusher_t)(ostream&);
+	inline recordwriter(ostream& o, flusher_t f, size_t maxrecs,
+						size_t maxbs = 0) noexcept
+	  : out(o), flusher(f), maxrecords(maxrecs), maxbytes(maxbs),
+		records(0), bytes(0) {}
+	template<class C>
+	inline bool write(const clas<C>& s, const C& obj) noexcept {
+		return end(s.write(obj, *this));
+	}
+	inline bool write(const value& v) noexcept {
+		return end(v.write(*this));
+	}
+	bool put(char_t c) noexcept {
+		++bytes;
+		return out.put(c);
+	}
+	/** flushes records written so far */
+	bool flush() noexcept;
+private:
+	bool end(bool) noexcept;
+	ostream& out;
+	const flusher_t flusher;
+	const size_t maxrecords;
+	const size_t maxbytes;
+	size_t records;
+	size_t bytes;
 };
 
 /**
  * scalar value read/write implementation based on externalized accessor X
+ * and number format F
  */
-template<class X>
+template<class X, class F = format::standard>
 struct scalar : value {
 	typedef typename X::type T;
 	bool read(lexer& in) const noexcept {
 		if( X::canlref ) {
 			if ( X::has() ) {
-				return reader<T>::read(X::lref(), in);
+				return F::read(X::lref(), in);
 			}
 		}
 		if( X::canset ) {
 			T v;
 			X::init(v);
-			if( reader<T>::read(v, in) ) {
+			if( F::read(v, in) ) {
 				X::set(v);
 				return true;
 			} else
@@ -1326,51 +2580,162 @@ struct scalar : value {
 	bool write(ostream& out) const noexcept {
 		if( X::has() ) {
 			if( X::canrref ) {
-				return writer<T>::write(X::rref(), out);
+				return F::write(X::rref(), out);
 			} else if( X::canget ) {
-				return writer<T>::write(X::get(), out);
+				return F::write(X::get(), out);
 			}
 		}
 		return value::null(out);
 	}
-	bool null()  const noexcept {
-		return X::null();
+	/* write-only value is not absent, it is written as null */
+	inline bool has() const noexcept {
+		return not (X::canget || X::canrref) || X::has();
+	}
+	bool null()  const noexcept {
+		return X::null();
+	}
+};
+
+
+/**
+ * string value implementation
+ */
+struct string : value {
+	inline string(char_t* s, size_t length) noexcept
+	  : str(s), size(length) {}
+	inline string(const char_t* s) noexcept
+	  : str(const_cast<char_t*>(s)), size(0) {}
+	bool read(lexer& in) const noexcept {
+		ctype ct;
+		if( ! isvalid(ct=in.value(ctype::stringnull)) )
+			return in.skip();
+		if( ct == ctype::null ) {
+			if( null() ) return true;
+			in.error(error_t::mismatch);
+			return false;
+		}
+		return reader<char_t*>::read(str, size, in);
+	}
+	bool write(ostream& out) const noexcept {
+		return str != nullptr ?
+			writer<char_t*>::write(str, out) : value::null(out);
+	}
+	inline bool null() const noexcept {
+		if( str != nullptr )
+			*str = 0;
+		return true;
+	}
+
+private:
+	char_t* const str;
+	const size_t size;
+};
+
+/**
+ * Sink for octets, such as decoded binary data
+ */
+struct octetsink {
+	/** writes n octets from src, returns true on success					*/
+	virtual bool write(const unsigned char* src, size_t n) noexcept = 0;
+};
+
+/**
+ * Binary data as base64 strings (RFC 4648), decoded straight from the lexer
+ * and encoded straight to the output stream
+ */
+namespace base64 {
+/** octets passed to a sink at once										*/
+static constexpr size_t block = 48;
+/** decodes a base64 string or null into sink, by blocks. Sets overrun if
+ *  the sink refuses data, bad on an invalid character or padding			*/
+bool read(lexer& in, octetsink& sink) noexcept;
+/** encodes n octets from src as a base64 string							*/
+bool write(const unsigned char* src, size_t n, ostream& out) noexcept;
+}
+
+/**
+ * Binary data of up to N octets, read and written as a base64 string
+ */
+template<size_t N>
+struct binary {
+	size_t size;
+	unsigned char data[N];
+	bool read(lexer& in) noexcept {
+		struct local : octetsink {
+			binary& dst;
+			inline local(binary& b) noexcept : dst(b) {}
+			bool write(const unsigned char* src, size_t n) noexcept {
+				const size_t k = n < N - dst.size ? n : N - dst.size;
+				for(size_t i = 0; i < k; ++i) dst.data[dst.size++] = src[i];
+				return k == n;
+			}
+		} sink(*this);
+		size = 0;
+		return base64::read(in, sink);
+	}
+	bool write(ostream& out) const noexcept {
+		return base64::write(data, size, out);
+	}
+};
+
+/**
+ * Fixed-point decimal number with up to D significant digits, F of them
+ * after the decimal point, stored as an integer scaled by 10^F.
+ * Numbers are read with rounding half away from zero, values beyond D
+ * digits are handled per config::overflow. Always written with F decimals
+ */
+template<unsigned D, unsigned F>
+struct decimal {
+	static_assert(F <= D && D <= 18, "Unsupported decimal precision");
+	typedef typename std::conditional<(D <= 4), int16_t,
+		typename std::conditional<(D <= 9), int32_t, int64_t>::type>::type
+		type;
+	typedef typename std::make_unsigned<type>::type utype;
+	static constexpr type scale = decimals::pow10<type>(F);
+	static constexpr type max = decimals::pow10<type>(D) - 1;
+	type raw;	/* value * 10^F												*/
+
+	bool read(lexer& in) noexcept {
+		utype mag;
+		bool neg;
+		if( ! decimals::read<utype>(mag, neg, F, in) ) return false;
+		if( mag > static_cast<utype>(max) &&
+				config::overflow != config::overflow_is::ignored ) {
+			mag = max;
+			if( config::overflow == config::overflow_is::error )
+				in.error(error_t::overflow);
+		}
+		raw = neg ? -static_cast<type>(mag) : static_cast<type>(mag);
+		return true;
+	}
+	bool write(ostream& out) const noexcept {
+		return decimals::write<utype>(raw < 0 ?
+			-static_cast<utype>(raw) : static_cast<utype>(raw),
+			raw < 0, F, out);
+	}
+	inline bool operator==(const decimal& that) const noexcept {
+		return raw == that.raw;
 	}
 };
 
-
 /**
- * string value implementation
+ * Binary data decoded from a base64 string by blocks and passed to
+ * consumer F. Returning false from F aborts decoding with overrun.
+ * Writing is not applicable
  */
-struct string : value {
-	inline string(char_t* s, size_t length) noexcept
-	  : str(s), size(length) {}
-	inline string(const char_t* s) noexcept
-	  : str(const_cast<char_t*>(s)), size(0) {}
+template<bool (*F)(const unsigned char*, size_t) noexcept>
+struct binarystream : value {
 	bool read(lexer& in) const noexcept {
-		ctype ct;
-		if( ! isvalid(ct=in.value(ctype::stringnull)) )
-			return in.skip();
-		if( ct == ctype::null ) {
-			if( null() ) return true;
-			in.error(error_t::mismatch);
-			return false;
-		}
-		return reader<char_t*>::read(str, size, in);
+		struct local : octetsink {
+			bool write(const unsigned char* src, size_t n) noexcept {
+				return F(src, n);
+			}
+		} sink;
+		return base64::read(in, sink);
 	}
 	bool write(ostream& out) const noexcept {
-		return str != nullptr ?
-			writer<char_t*>::write(str, out) : value::null(out);
-	}
-	inline bool null() const noexcept {
-		if( str != nullptr )
-			*str = 0;
-		return true;
+		return value::null(out);
 	}
-
-private:
-	char_t* const str;
-	const size_t size;
 };
 
 /**
@@ -1413,21 +2778,22 @@ struct cstrings : value {
 
 /**
  * property read/write implementation based on externalized accessor X
+ * and number format F
  */
-template<class X>
+template<class X, class F = format::standard>
 struct propertyx : property<typename X::clas> {
 	typedef typename X::type T;
 	typedef typename X::clas C;
 	bool read(C& obj, lexer& in) const noexcept {
 		if( X::canlref ) {
 			if( X::has() ) {
-				return reader<T>::read(X::lref(obj), in);
+				return F::read(X::lref(obj), in);
 			}
 		}
 		if( X::canset ) {
 			T v;
 			X::init(v);
-			if( reader<T>::read(v, in) ) {
+			if( F::read(v, in) ) {
 				X::set(obj, v);
 				return true;
 			} else
@@ -1437,11 +2803,15 @@ struct propertyx : property<typename X::clas> {
 			return in.skip();
 		}
 	}
+	/* write-only property is not absent, it is written as null */
+	bool has(const C&) const noexcept {
+		return not (X::canget || X::canrref) || X::has();
+	}
 	bool write(const C& obj, ostream& out) const noexcept {
 		if( X::canrref ) {
-			return writer<T>::write(X::rref(obj), out);
+			return F::write(X::rref(obj), out);
 		} else if( X::canget ) {
-			return writer<T>::write(X::get(obj), out);
+			return F::write(X::get(obj), out);
 		}
 		return value::null(out);
 	}
@@ -1468,6 +2838,8 @@ struct vector : value {
 		else
 			return value::null(out);
 	}
+	/** vector is always written, even if empty */
+	static inline constexpr bool has() noexcept { return true; }
 
 private:
 	friend class array;
@@ -1504,32 +2876,92 @@ struct values_selector<X, true> : vector<X> {};
 template<class X>
 struct values_selector<X, false> : scalar<X> {};
 
+/**
+ * true if accessor X is a generator
+ */
+template<class X>
+class generative {
+	template<class Y>
+	static constexpr bool test(decltype(Y::is_generator)*) noexcept {
+		return Y::is_generator;
+	}
+	template<class Y>
+	static constexpr bool test(...) noexcept { return false; }
+public:
+	static constexpr bool value = test<X>(nullptr);
+};
+
+/**
+ * array written from generator X, elements are written with E
+ */
+template<class X, class E>
+struct generated : value {
+	bool read(lexer& in) const noexcept {
+		in.error(error_t::noobject);
+		return in.skip();
+	}
+	bool write(ostream& out) const noexcept {
+		bool first = true;
+		const bool r = X::each([&out, &first](const typename X::type& v)
+				noexcept -> bool {
+			const bool dlm = array::dlm(first, out);
+			first = false;
+			return dlm && E::write(v, out);
+		});
+		return r && (not first || array::dlm(true, out)) && array::end(out);
+	}
+	/** generated array is always written, even if empty */
+	static inline constexpr bool has() noexcept { return true; }
+};
+
+/** writes a generated element with writer<T> */
+template<typename T>
+struct generatedscalar {
+	static inline bool write(const T& v, ostream& out) noexcept {
+		return writer<T>::write(v, out);
+	}
+};
+
 /**
  * value implementation selector based on accessor type
  */
 template<class X>
-struct values : values_selector<X,X::is_vector> {};
+struct values : std::conditional<generative<X>::value,
+		generated<X, generatedscalar<typename X::type>>,
+		values_selector<X,X::is_vector>>::type {};
 
 /**
  * object as a value read/write implementation based on externalized accessor X
  */
 template<class X, const clas<typename X::clas>& (*S)() noexcept>
 struct objectval : value {
+	typedef typename X::type T;
 	bool read(lexer& in) const noexcept {
 		if( X::canlref ) {
 			if ( X::has() ) {
 				return S().read(X::lref(), in);
 			}
+		} else if( X::canset && X::canget ) {
+			/* members absent in input retain their current values */
+			T v = X::get();
+			if( S().read(v, in) ) {
+				X::set(v);
+				return true;
+			} else
+				return false;
 		}
 		in.error(error_t::noobject);
 		return in.skip();
 	}
 	bool write(ostream& out) const noexcept {
-		if( X::canrref && X::has() ) {
-			return S().write(X::rref(), out);
-		} else {
-			return null(out);
+		if( X::has() ) {
+			if( X::canrref ) {
+				return S().write(X::rref(), out);
+			} else if( X::canget ) {
+				return S().write(X::get(), out);
+			}
 		}
+		return null(out);
 	}
 };
 
@@ -1542,7 +2974,8 @@ struct objectlist : value {
 	bool read(lexer& in) const noexcept {
 		if( X::canset ) {
 			//return array::read(*this,in);
-			return collection<>::read(*this, void_v, in);
+			trail order;
+			return collection<>::read(*this, order, in);
 		} else {
 			in.error(error_t::noobject);
 			return in.skip();
@@ -1561,9 +2994,9 @@ private:
 	friend class array;
 	friend class collection<>;
 
-	inline bool read(const void_t&, lexer& in, size_t i) const noexcept {
+	inline bool read(trail& order, lexer& in, size_t i) const noexcept {
 		if( X::has(i) ) {
-			if( S().read(X::lref(i), in) )
+			if( S().read(X::lref(i), in, order) )
 				return true;
 			else
 				return in.skip(false);
@@ -1572,9 +3005,8 @@ private:
 			return false;
 		}
 	}
-	template<typename T>
-	static inline constexpr bool null(T v) noexcept {
-		return X::null(v);
+	static inline constexpr bool null(trail&) noexcept {
+		return X::null(void_v);
 	}
 
 	inline bool write(ostream& out, size_t i) const noexcept {
@@ -1582,34 +3014,340 @@ private:
 	}
 };
 
+/** writes a generated element with structure S */
+template<typename T, const clas<T>& (*S)() noexcept>
+struct generatedobject {
+	static inline bool write(const T& v, ostream& out) noexcept {
+		return S().write(v, out);
+	}
+};
+
 template<class X, const clas<typename X::type>& (*S)() noexcept>
 struct objects
-  : std::conditional<X::is_vector,
-		objectlist<X,S>, objectval<X,S>>::type {
+  : std::conditional<generative<X>::value,
+		generated<X, generatedobject<typename X::type, S>>,
+		typename std::conditional<X::is_vector,
+			objectlist<X,S>, objectval<X,S>>::type>::type {
+};
+
+/**
+ * array of unlimited length consumed element by element
+ * Each element is read into one reusable buffer and passed to consumer F
+ * along with its index. F may apply backpressure by returning only when it
+ * is ready to accept the next element. Returning false aborts consuming,
+ * the rest of the array is skipped and error_t::overrun is set, as with
+ * objectlist. Elements that fail to read are skipped.
+ * S reads an element, writing is not applicable
+ */
+template<typename T, class S, bool (*F)(const T&, size_t) noexcept>
+struct stream : value {
+	bool read(lexer& in) const noexcept {
+		frame f {};
+		return collection<>::read(*this, f, in);
+	}
+	bool write(ostream& out) const noexcept {
+		return value::null(out);
+	}
+private:
+	friend class collection<>;
+	/** reusable element and the member order kept across elements */
+	struct frame {
+		T item;
+		trail order;
+	};
+	inline bool read(frame& f, lexer& in, size_t i) const noexcept {
+		f.item = T();
+		if( ! S::read(f.item, in, f.order) ) return in.skip(false);
+		if( F(f.item, i) ) return true;
+		in.error(error_t::overrun);
+		return false;
+	}
+	static inline constexpr bool null(frame&) noexcept {
+		return not config::null_is_error;
+	}
+};
+
+/** reads a stream element with reader<T> */
+template<typename T>
+struct streamscalar {
+	static inline bool read(T& item, lexer& in, trail&) noexcept {
+		return reader<T>::read(item, in);
+	}
+};
+
+/** reads a stream element with structure S */
+template<typename T, const clas<T>& (*S)() noexcept>
+struct streamobject {
+	static inline bool read(T& item, lexer& in, trail& order) noexcept {
+		return S().read(item, in, order);
+	}
+};
+
+/**
+ * jsontext - JSON text of a constant value composed at compile time
+ * N - capacity, length - actual length of the text
+ */
+template<size_t N>
+struct jsontext {
+	static constexpr size_t capacity = N;
+	char_t data[N + 1];
+	size_t length;
+	constexpr jsontext() noexcept : data{}, length(0) {}
+	/** text of given characters */
+	template<typename ... C>
+	explicit constexpr jsontext(char_t c, C ... l) noexcept
+	  : data{c, static_cast<char_t>(l)...}, length(1 + sizeof...(C)) {}
+	/** text a followed by text b, I - indices of data */
+	template<size_t ... I, size_t A, size_t B>
+	constexpr jsontext(indices<I...>, const jsontext<A>& a,
+			const jsontext<B>& b) noexcept
+	  : data{ at(a, b, I)... }, length(a.length + b.length) {}
+private:
+	template<size_t A, size_t B>
+	static constexpr char_t at(const jsontext<A>& a, const jsontext<B>& b,
+			size_t i) noexcept {
+		return i < a.length ? a.data[i] :
+			i - a.length < b.length ? b.data[i - a.length] : char_t(0);
+	}
+};
+
+/** text of capacity N composed of texts a and b */
+template<size_t N, size_t A, size_t B>
+constexpr jsontext<N> join(const jsontext<A>& a, const jsontext<B>& b) noexcept {
+	return jsontext<N>(typename make_indices<N>::type(), a, b);
+}
+
+template<size_t N, size_t A, size_t B, size_t C>
+constexpr jsontext<N> join(const jsontext<A>& a, const jsontext<B>& b,
+		const jsontext<C>& c) noexcept {
+	return join<N>(join<N>(a, b), c);
+}
+
+/**
+ * jsonof - conversion of a constant to its JSON text
+ */
+template<typename T, bool = std::is_integral<T>::value>
+struct jsonof;
+
+template<size_t N>
+struct jsonof<jsontext<N>, false> {
+	typedef jsontext<N> type;
+	static constexpr const type& text(const type& v) noexcept { return v; }
+};
+
+template<>
+struct jsonof<std::nullptr_t, false> {
+	typedef jsontext<4> type;
+	static constexpr type text(std::nullptr_t) noexcept {
+		return type('n','u','l','l');
+	}
+};
+
+template<>
+struct jsonof<bool, true> {
+	typedef jsontext<5> type;
+	static constexpr type text(bool v) noexcept {
+		return v ? type('t','r','u','e') : type('f','a','l','s','e');
+	}
+};
+
+template<typename T>
+struct jsonof<T, true> {
+	typedef jsontext<std::numeric_limits<T>::digits10 + 2> type;
+	typedef jsontext<type::capacity - 1> digits_t;
+	static constexpr jsontext<1> digit(T d) noexcept {
+		return jsontext<1>(literal::digit0 + (d < 0 ? -d : d));
+	}
+	/* digits of the absolute value, most significant first */
+	static constexpr digits_t digits(T v) noexcept {
+		return v / 10
+			? join<digits_t::capacity>(digits(v / 10), digit(v % 10))
+			: join<digits_t::capacity>(digit(v), jsontext<0>());
+	}
+	static constexpr type text(T v) noexcept {
+		return join<type::capacity>(v < 0 ? jsontext<1>(literal::minus)
+			: jsontext<1>(), digits(v));
+	}
+};
+
+template<size_t N>
+struct jsonof<char_t[N], false> {
+	/* escaped character takes up to six: \u001F */
+	typedef jsontext<6 * (N - 1) + 2> type;
+	static constexpr char_t hex(unsigned v) noexcept {
+		return v < 10 ? literal::digit0 + v : literal::digitA + v - 10;
+	}
+	static constexpr jsontext<6> escaped(char_t c, unsigned u) noexcept {
+		return u < static_cast<unsigned>(literal::ws)
+			? literal::replace_common(c) != c
+				? jsontext<6>(literal::escape, literal::replace_common(c))
+				: jsontext<6>(literal::escape, literal::hex_mark,
+					literal::digit0, literal::digit0, hex(u >> 4), hex(u & 0xF))
+			: literal::is_escaped(c)
+				? jsontext<6>(literal::escape, c)
+				: jsontext<6>(c);
+	}
+	/* escaped characters of s starting from i */
+	static constexpr type body(const char_t (&s)[N], size_t i) noexcept {
+		return i < N - 1 && s[i]
+			? join<type::capacity>(escaped(s[i],
+				static_cast<typename std::make_unsigned<char_t>::type>(s[i])),
+				body(s, i + 1))
+			: type();
+	}
+	static constexpr type text(const char_t (&s)[N]) noexcept {
+		return join<type::capacity>(jsontext<1>(literal::quotation_mark),
+			body(s, 0), jsontext<1>(literal::quotation_mark));
+	}
+};
+
+template<typename ... L>
+struct jsonlist;
+
+template<>
+struct jsonlist<> {
+	static constexpr size_t capacity = 0;
+	static constexpr jsontext<0> text(bool) noexcept { return jsontext<0>(); }
+};
+
+template<typename T, typename ... L>
+struct jsonlist<T, L...> {
+	typedef jsonof<typename std::remove_cv<T>::type> J;
+	static constexpr size_t capacity =
+		J::type::capacity + 1 + jsonlist<L...>::capacity;
+	static constexpr jsontext<capacity> text(bool first, const T& v,
+			const L& ... l) noexcept {
+		return join<capacity>(first ? jsontext<1>()
+			: jsontext<1>(literal::value_separator), J::text(v),
+			jsonlist<L...>::text(false, l...));
+	}
+};
+
+/**
+ * constant - a read-only value with JSON text J prepared at compile time.
+ * Text is stored in an array of exact length, on AVR in progmem
+ * if cstring_is::avr_progmem, and written with a single bulk put
+ */
+template<typename T, const T& J,
+	class I = typename make_indices<J.length>::type,
+	bool P = config::cstring == config::cstring_is::avr_progmem>
+struct constant;
+
+template<typename T, const T& J, size_t ... I>
+struct constant<T, J, indices<I...>, false> : value {
+	/** length of the JSON text */
+	static constexpr size_t length = J.length;
+	static constexpr char_t text[length + 1] { J.data[I]..., 0 };
+	bool read(lexer& in) const noexcept {
+		in.error(error_t::noobject);
+		return in.skip();
+	}
+	bool write(ostream& out) const noexcept {
+		return out.putn(text, length);
+	}
+};
+
+template<typename T, const T& J, size_t ... I>
+struct constant<T, J, indices<I...>, true> : value {
+	static constexpr size_t length = J.length;
+	static constexpr char_t text[length + 1] { J.data[I]..., 0 };
+	bool read(lexer& in) const noexcept {
+		in.error(error_t::noobject);
+		return in.skip();
+	}
+	bool write(ostream& out) const noexcept {
+		return out.puts(progmem<char_t>(text));
+	}
 };
 
+template<typename T, const T& J, size_t ... I>
+constexpr char_t constant<T, J, indices<I...>, false>::text[];
+
+template<typename T, const T& J, size_t ... I>
+constexpr char_t constant<T, J, indices<I...>, true>::text[]
+#if __AVR__
+	__attribute__((progmem))
+#endif
+	;
+}
+using details::dictionary;
+using details::presence;
+using details::bitmap;
+using details::binary;
+using details::octetsink;
+using details::decimal;
+using details::validator;
+using details::validate;
+using details::minify;
+using details::canonicalize;
+namespace format = details::format;
+
+/**
+ * Composers of JSON text for constant values, evaluated at compile time.
+ * Values are integral numbers, bool, nullptr, string literals and texts
+ * composed with array, object and member. Use with V<T,J> as
+ *   static constexpr auto caps = json::object(
+ *       json::member("name", "dev"), json::member("ports", json::array(1,2)));
+ *   V<decltype(caps), caps>().write(out);
+ */
+namespace json {
+/** JSON array of given values */
+template<typename ... L>
+constexpr details::jsontext<details::jsonlist<L...>::capacity + 2>
+array(const L& ... l) noexcept {
+	return details::join<details::jsonlist<L...>::capacity + 2>(
+		details::jsontext<1>(details::literal::begin_array),
+		details::jsonlist<L...>::text(true, l...),
+		details::jsontext<1>(details::literal::end_array));
+}
+
+/** named member of an object */
+template<size_t N, typename T>
+constexpr details::jsontext<details::jsonof<char_t[N]>::type::capacity + 1 +
+	details::jsonof<typename std::remove_cv<T>::type>::type::capacity>
+member(const char_t (&name)[N], const T& v) noexcept {
+	return details::join<details::jsonof<char_t[N]>::type::capacity + 1 +
+		details::jsonof<typename std::remove_cv<T>::type>::type::capacity>(
+		details::jsonof<char_t[N]>::text(name),
+		details::jsontext<1>(details::literal::name_separator),
+		details::jsonof<typename std::remove_cv<T>::type>::text(v));
+}
+
+/** JSON object of given members */
+template<typename ... L>
+constexpr details::jsontext<details::jsonlist<L...>::capacity + 2>
+object(const L& ... l) noexcept {
+	return details::join<details::jsonlist<L...>::capacity + 2>(
+		details::jsontext<1>(details::literal::begin_object),
+		details::jsonlist<L...>::text(true, l...),
+		details::jsontext<1>(details::literal::end_object));
+}
 }
+using recordwriter = details::recordwriter;
 
 namespace details {
 
 /**
- * scalar class property
+ * scalar class property, F - number format
  */
 
-template<class C, details::name id, typename T, T C::*V>
+template<class C, details::name id, typename T, T C::*V,
+	class F = details::format::standard>
 inline const details::property<C> & PropertyScalarMember() noexcept {
-	static const struct local : details::propertyx<accessor::field<C,T,V>> {
+	static const struct local : details::propertyx<accessor::field<C,T,V>,F> {
 		cstring name() const noexcept { return id(); }
 	} l;
 	return l;
 }
 
 /** PropertyScalarAccessor
- * scalar class property via getter/setter wrapped in accessor
+ * scalar class property via getter/setter wrapped in accessor,
+ * F - number format
  */
-template<class C, details::name id, class X>
+template<class C, details::name id, class X,
+	class F = details::format::standard>
 inline const details::property<C> & PropertyScalarAccessor() noexcept {
-	static const struct local : details::propertyx<X> {
+	static const struct local : details::propertyx<X,F> {
 		cstring name() const noexcept { return id(); }
 	} l;
 	return l;
@@ -1744,14 +3482,23 @@ inline const details::property<C> & PropertyArrayOfObjects() {
 	static const struct local : details::property<C> {
 		cstring name() const noexcept { return id(); }
 		bool read(C& obj, details::lexer& in) const noexcept {
-			return details::collection<>::read(*this, obj, in);
+			frame f { obj, {} };
+			return details::collection<>::read(*this, f, in);
 		}
 		bool write(const C& obj, details::ostream& out) const noexcept {
 			return details::array::write(*this, obj, out);
 		}
+		/** object and the member order kept across items */
+		struct frame {
+			C& obj;
+			details::trail order;
+		};
+		static inline constexpr bool null(frame& f) noexcept {
+			return details::property<C>::null(f.obj);
+		}
 		/** read item */
-		inline bool read(C& obj, details::lexer& in, size_t i) const noexcept {
-			S().read((obj.*V)[i], in);
+		inline bool read(frame& f, details::lexer& in, size_t i) const noexcept {
+			S().read((f.obj.*V)[i], in, f.order);
 			return i < N-1;
 		}
 		/** write item item */
@@ -1838,6 +3585,15 @@ inline const details::value& ValueArray() noexcept {
 	return l;
 }
 
+/** ValueConstant
+ * read-only value with JSON text J composed at compile time
+ */
+template<typename T, const T& J>
+inline const details::value& ValueConstant() noexcept {
+	static const details::constant<T,J> l;
+	return l;
+}
+
 /** ValueString
  * JSON string bound to an array char_t[N]
  */
@@ -1875,6 +3631,44 @@ inline const details::value& ValueAccessor() noexcept {
 	return l;
 }
 
+/** ValueScalarAccessor
+ * a single scalar value accessed via accessor class X, F - number format
+ */
+template<class X, class F>
+inline const details::value& ValueScalarAccessor() noexcept {
+	static const details::scalar<X,F> l;
+	return l;
+}
+
+/** ValueStream
+ * array of scalars of unlimited length, passed to consumer F one by one
+ */
+template<typename T, bool (*F)(const T&, size_t) noexcept>
+inline const details::value& ValueStream() noexcept {
+	static const details::stream<T, details::streamscalar<T>, F> l;
+	return l;
+}
+
+/** ValueObjectStream
+ * array of objects of unlimited length structured with S,
+ * passed to consumer F one by one
+ */
+template<class T, const details::clas<T>& (*S)() noexcept,
+	bool (*F)(const T&, size_t) noexcept>
+inline const details::value& ValueObjectStream() noexcept {
+	static const details::stream<T, details::streamobject<T,S>, F> l;
+	return l;
+}
+
+/** ValueBinaryStream
+ * binary data in base64, decoded by blocks and passed to consumer F
+ */
+template<bool (*F)(const unsigned char*, size_t) noexcept>
+inline const details::value& ValueBinaryStream() noexcept {
+	static const details::binarystream<F> l;
+	return l;
+}
+
 /** ValueObjectAccessor
  * a object or a vector of object unspecified length
  * accessed via accessor class X and structured with S.
@@ -1886,11 +3680,11 @@ inline const details::value& ValueObjectAccessor() noexcept {
 }
 
 /** ValuePointer
- * value - plain variable via pointer
+ * value - plain variable via pointer, F - number format
  */
-template<typename T, T* P>
+template<typename T, T* P, class F = details::format::standard>
 inline const details::value& ValuePointer() noexcept {
-	static const details::scalar<accessor::pointer<T,P>> l;
+	static const details::scalar<accessor::pointer<T,P>,F> l;
 	return l;
 }
 
@@ -2001,6 +3795,9 @@ inline const details::member& MemberAccessor() noexcept {
 		bool writeval(details::ostream& out) const noexcept {
 			return details::values<X>::write(out);
 		}
+		bool has() const noexcept {
+			return details::values<X>::has();
+		}
 	} l;
 	return l;
 }
@@ -2054,6 +3851,9 @@ const details::member& MemberPointerFunction() noexcept {
 		bool writeval(details::ostream& out) const noexcept {
 			return details::scalar<accessor::function<T,F>>::write(out);
 		}
+		bool has() const noexcept {
+			return details::scalar<accessor::function<T,F>>::has();
+		}
 	} l;
 	return l;
 }
@@ -2068,6 +3868,14 @@ const details::property<C> & P() noexcept {
 	return details::PropertyScalarMember<C,id,T,V>();
 }
 
+/**
+ * scalar class property with number format F, see format::
+ */
+template<class C, details::name id, typename T, T C::*V, class F>
+const details::property<C> & P() noexcept {
+	return details::PropertyScalarMember<C,id,T,V,F>();
+}
+
 /**
  * scalar class property via getter/setter wrapped in accessor
  */
@@ -2076,6 +3884,14 @@ const details::property<C> & P() noexcept {
 	return details::PropertyScalarAccessor<C,id,X>();
 }
 
+/**
+ * scalar class property via accessor with number format F
+ */
+template<class C, details::name id, class X, class F>
+const details::property<C> & P() noexcept {
+	return details::PropertyScalarAccessor<C,id,X,F>();
+}
+
 /**
  * string class property
  */
@@ -2190,6 +4006,14 @@ const details::value& V() noexcept {
 	return details::ValueAccessor<X>();
 }
 
+/**
+ * a single scalar value accessed via accessor class X with number format F
+ */
+template<class X, class F>
+const details::value& V() noexcept {
+	return details::ValueScalarAccessor<X,F>();
+}
+
 
 /**
  * a object or a vector of object unspecified length
@@ -2201,6 +4025,41 @@ const details::value& V() noexcept {
 	return details::ValueObjectAccessor<X,S>();
 }
 
+/**
+ * binary data in base64, decoded by blocks and passed to consumer F
+ */
+template<bool (*F)(const unsigned char*, size_t) noexcept>
+const details::value& V() noexcept {
+	return details::ValueBinaryStream<F>();
+}
+
+/**
+ * array of scalars of unlimited length, elements are read one by one
+ * into a reusable buffer and passed to consumer F
+ */
+template<typename T, bool (*F)(const T&, size_t) noexcept>
+const details::value& V() noexcept {
+	return details::ValueStream<T,F>();
+}
+
+/**
+ * array of objects of unlimited length structured with S, elements are
+ * read one by one into a reusable buffer and passed to consumer F
+ */
+template<class T, const details::clas<T>& (*S)() noexcept,
+	bool (*F)(const T&, size_t) noexcept>
+const details::value& V() noexcept {
+	return details::ValueObjectStream<T,S,F>();
+}
+
+/**
+ * constant value with JSON text J composed at compile time, see json::
+ */
+template<typename T, const T& J>
+const details::value& V() noexcept {
+	return details::ValueConstant<T,J>();
+}
+
 /**
  * value - plain variable via pointer
  */
@@ -2209,6 +4068,14 @@ const details::value& V() noexcept {
 	return details::ValuePointer<T,P>();
 }
 
+/**
+ * value - plain variable via pointer with number format F
+ */
+template<typename T, T* P, class F>
+const details::value& V() noexcept {
+	return details::ValuePointer<T,P,F>();
+}
+
 /**
  * value - plain variable by function returning reference
  */
@@ -2353,6 +4220,39 @@ inline bool Read(T& value, details::istream& in) noexcept {
 	return Read(value, lex);
 }
 
+/**
+ * Reads a JSON value of compatible type from input of given validation mode
+ * Use lexer::input::trusted for well-formed input, such as persisted state
+ */
+template<typename T>
+inline bool Read(T& value, details::istream& in,
+		details::lexer::input mode) noexcept {
+	lexer lex(in, nullptr, mode);
+	return Read(value, lex);
+}
+
+/**
+ * Reads consecutive NDJSON records with structure S into obj,
+ * calling handler(obj, error) after each record. A malformed record
+ * is skipped up to the end of line. Handler returns false to stop.
+ * Members missing in a record retain values of the previous one.
+ * Returns number of records read
+ */
+template<class C, class F>
+size_t ReadRecords(const details::clas<C>& S, C& obj, details::lexer& in,
+		F handler) noexcept {
+	size_t n = 0;
+	details::trail order;
+	while( in.next() ) {
+		/* a record of another type is not consumed by S, skip it		*/
+		if( ! S.read(obj, in, order) && in.error() == details::error_t::mismatch )
+			in.skip(false);
+		++n;
+		if( ! handler(obj, in.error()) ) break;
+	}
+	return n;
+}
+
 
 namespace details {
 /****************************************************************************
@@ -2389,10 +4289,22 @@ public:
 			error(error_t::eof);
 			return false;
 		}
-		++pos;
 		val = ptr[pos++];
 		return true;
 	}
+	const char_t* head() const noexcept {
+		return ptr != nullptr ? ptr + pos : nullptr;
+	}
+	size_t ahead(size_t n) const noexcept {
+		if( ptr == nullptr ) return 0;
+		if( size() ) return n < size() - pos ? n : size() - pos;
+		size_t i = 0;
+		while( i < n && ptr[pos + i] ) ++i;
+		return i;
+	}
+	void advance(size_t n) noexcept {
+		pos += n;
+	}
 	bool put(char_t val) noexcept {
 		if( pos >= size() ) {
 			error(error_t::eof);
@@ -2401,6 +4313,15 @@ public:
 		ptr[pos++] = val;
 		return true;
 	}
+	bool putn(const char_t* s, size_t n) noexcept {
+		if( n > size() - pos ) {
+			while( put(*s++) ); /* fill up to the end and set error */
+			return false;
+		}
+		for(size_t i = 0; i < n; ++i) ptr[pos + i] = s[i];
+		pos += n;
+		return true;
+	}
 	inline void restart() noexcept {
 		clear();
 		pos = 0;
@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * cojson_concurrent.hpp - snapshot accessors for state shared with
+ * concurrent producers. For host builds only
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+/*
+ * seqlock<T> and doublebuffer<T> hold a trivially copyable value updated
+ * by a producer thread and read by any number of consumer threads without
+ * locks. load() returns a consistent copy, store() publishes a new value.
+ * Stores to the same object must be serialized by the producers.
+ *
+ * seqlock<T> keeps one copy, readers retry while a store is in progress.
+ * doublebuffer<T> keeps two copies, a store writes the copy readers are not
+ * on and then publishes it. Readers retry only if the next store begins
+ * rewriting the copy they are reading, that is two stores during one read.
+ *
+ * accessor::snapshot and accessor::snapshotfield expose them to V<>, M<>
+ * and P<> as get/set accessors: a value or an object is copied once onto
+ * the stack before writing, so the JSON text is internally consistent and
+ * the producer is never blocked by the serialization. A read (PUT) fills
+ * a copy of the current value and publishes it only if reading succeeds.
+ *
+ * accessor::atomic and accessor::atomicfield map std::atomic<T> with
+ * relaxed loads and stores. counter<T,N> spreads increments of many
+ * threads over N cache line padded shards, so the increment stays a
+ * single uncontended relaxed add; shards are summed when serialized.
+ * counter<T,N> works with accessor::snapshot, a PUT resets it.
+ */
+
+#pragma once
+#include <atomic>
+#include <string.h>
+#include <type_traits>
+#include "cojson.hpp"
+
+namespace cojson {
+namespace details {
+
+/**
+ * Sequence lock protected value
+ */
+template<typename T>
+class seqlock {
+public:
+	static_assert(std::is_trivially_copyable<T>::value,
+		"seqlock requires a trivially copyable type");
+	typedef T type;
+	inline seqlock() noexcept : seq(0), data() {}
+	inline seqlock(const T& v) noexcept : seq(0), data(v) {}
+
+	/** returns a consistent copy, spins while a store is in progress	*/
+	T load() const noexcept {
+		T copy;
+		unsigned s;
+		do {
+			while( (s = seq.load(std::memory_order_acquire)) & 1 );
+			memcpy(&copy, &data, sizeof(T));
+			std::atomic_thread_fence(std::memory_order_acquire);
+		} while( seq.load(std::memory_order_relaxed) != s );
+		return copy;
+	}
+	void store(const T& v) noexcept {
+		const unsigned s = seq.load(std::memory_order_relaxed);
+		seq.store(s + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(&data, &v, sizeof(T));
+		seq.store(s + 2, std::memory_order_release);
+	}
+private:
+	std::atomic<unsigned> seq;
+	T data;
+};
+
+/**
+ * Value with two copies, a store writes the copy not being read
+ */
+template<typename T>
+class doublebuffer {
+public:
+	static_assert(std::is_trivially_copyable<T>::value,
+		"doublebuffer requires a trivially copyable type");
+	typedef T type;
+	inline doublebuffer() noexcept : seq(0), ver{{0}, {0}}, data() {}
+	inline doublebuffer(const T& v) noexcept
+	  : seq(0), ver{{0}, {0}}, data{v, v} {}
+
+	/** returns a consistent copy, does not wait for a store in progress */
+	T load() const noexcept {
+		T copy;
+		while( true ) {
+			const unsigned i = seq.load(std::memory_order_acquire) & 1;
+			const unsigned v = ver[i].load(std::memory_order_acquire);
+			if( v & 1 ) continue; /* the next store is rewriting this copy */
+			memcpy(&copy, &data[i], sizeof(T));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if( ver[i].load(std::memory_order_relaxed) == v ) return copy;
+		}
+	}
+	void store(const T& v) noexcept {
+		const unsigned s = seq.load(std::memory_order_relaxed);
+		const unsigned i = (s + 1) & 1;
+		const unsigned n = ver[i].load(std::memory_order_relaxed);
+		ver[i].store(n + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(&data[i], &v, sizeof(T));
+		ver[i].store(n + 2, std::memory_order_release);
+		seq.store(s + 1, std::memory_order_release);
+	}
+private:
+	std::atomic<unsigned> seq;
+	std::atomic<unsigned> ver[2];	/* odd while the copy is written	*/
+	T data[2];
+};
+
+/**
+ * Counter sharded by threads, each shard occupies its own cache line.
+ * Threads are assigned shards round-robin on first increment
+ */
+template<typename T, size_t N = 16>
+class counter {
+public:
+	static_assert(N && (N & (N - 1)) == 0, "N must be a power of 2");
+	static constexpr size_t cacheline = 64;
+	typedef T type;
+	inline counter() noexcept : shards() {}
+
+	inline void add(T n = 1) noexcept {
+		shards[slot()].value.fetch_add(n, std::memory_order_relaxed);
+	}
+	/** returns sum of all shards										*/
+	T load() const noexcept {
+		T sum = 0;
+		for(size_t i = 0; i < N; ++i)
+			sum += shards[i].value.load(std::memory_order_relaxed);
+		return sum;
+	}
+	/** sets the counter to v, each shard is cleared atomically, so
+	 *  concurrent increments are counted either before or after reset	*/
+	void store(T v) noexcept {
+		for(size_t i = 0; i < N; ++i)
+			shards[i].value.store(0, std::memory_order_relaxed);
+		shards[0].value.fetch_add(v, std::memory_order_relaxed);
+	}
+private:
+	static size_t slot() noexcept {
+		static std::atomic<size_t> next(0);
+		static thread_local size_t index =
+			next.fetch_add(1, std::memory_order_relaxed) & (N - 1);
+		return index;
+	}
+	struct alignas(cacheline) shard {
+		std::atomic<T> value;
+	};
+	shard shards[N];
+};
+
+} /* namespace details */
+
+using details::seqlock;
+using details::doublebuffer;
+using details::counter;
+
+namespace accessor {
+
+/**
+ * Accessor for a static seqlock<T>, doublebuffer<T> or counter<T,N>
+ * via pointer
+ */
+template<class L, L* P>
+struct snapshot {
+	typedef typename L::type clas;
+	typedef typename L::type type;
+	static constexpr bool canget = true;
+	static constexpr bool canset = true;
+	static constexpr bool canlref   = false;
+	static constexpr bool canrref   = false;
+	static constexpr bool is_vector = false;
+	static inline constexpr bool has() noexcept { return true; }
+	static inline type get() noexcept { return P->load(); }
+	static type& lref() noexcept;			/* not possible */
+	static const type& rref() noexcept;		/* not possible */
+	static inline void set(const type& v) noexcept { P->store(v); }
+	static inline constexpr bool null(void_t) noexcept {
+		return not config::null_is_error;
+	}
+	static inline void init(type&) noexcept { }
+private:
+	snapshot();
+};
+
+/**
+ * Accessor for a seqlock<T>, doublebuffer<T> or counter<T,N> member
+ * of class C
+ */
+template<class C, class L, L C::*V>
+struct snapshotfield {
+	typedef C clas;
+	typedef typename L::type type;
+	static constexpr bool canget = true;
+	static constexpr bool canset = true;
+	static constexpr bool canlref   = false;
+	static constexpr bool canrref   = false;
+	static constexpr bool is_vector = false;
+	static inline constexpr bool has() noexcept { return true; }
+	static inline type get(const C& o) noexcept { return (o.*V).load(); }
+	static type& lref(C&) noexcept;				/* not possible */
+	static const type& rref(const C&) noexcept;	/* not possible */
+	static inline void set(C& o, const type& v) noexcept {
+		(o.*V).store(v);
+	}
+	static inline void init(type&) noexcept { }
+	static inline constexpr bool null(C&) noexcept {
+		return not config::null_is_error;
+	}
+private:
+	snapshotfield();
+};
+
+/**
+ * Accessor for a static std::atomic<T> via pointer, relaxed ordering
+ */
+template<typename T, std::atomic<T>* P>
+struct atomic {
+	typedef T clas;
+	typedef T type;
+	static constexpr bool canget = true;
+	static constexpr bool canset = true;
+	static constexpr bool canlref   = false;
+	static constexpr bool canrref   = false;
+	static constexpr bool is_vector = false;
+	static inline constexpr bool has() noexcept { return true; }
+	static inline T get() noexcept {
+		return P->load(std::memory_order_relaxed);
+	}
+	static T& lref() noexcept;			/* not possible */
+	static const T& rref() noexcept;	/* not possible */
+	static inline void set(const T& v) noexcept {
+		P->store(v, std::memory_order_relaxed);
+	}
+	static inline constexpr bool null(void_t) noexcept {
+		return not config::null_is_error;
+	}
+	static inline void init(T&) noexcept { }
+private:
+	atomic();
+};
+
+/**
+ * Accessor for a std::atomic<T> member of class C, relaxed ordering
+ */
+template<class C, typename T, std::atomic<T> C::*V>
+struct atomicfield {
+	typedef C clas;
+	typedef T type;
+	static constexpr bool canget = true;
+	static constexpr bool canset = true;
+	static constexpr bool canlref   = false;
+	static constexpr bool canrref   = false;
+	static constexpr bool is_vector = false;
+	static inline constexpr bool has() noexcept { return true; }
+	static inline T get(const C& o) noexcept {
+		return (o.*V).load(std::memory_order_relaxed);
+	}
+	static T& lref(C&) noexcept;				/* not possible */
+	static const T& rref(const C&) noexcept;	/* not possible */
+	static inline void set(C& o, const T& v) noexcept {
+		(o.*V).store(v, std::memory_order_relaxed);
+	}
+	static inline void init(T&) noexcept { }
+	static inline constexpr bool null(C&) noexcept {
+		return not config::null_is_error;
+	}
+private:
+	atomicfield();
+};
+
+}
+}
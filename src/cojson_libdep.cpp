@@ -96,28 +96,31 @@ template<typename C, typename T,
 struct any_printf  {
 	static constexpr bool present = hasswprintf || hassnprintf || hassprintf;
 	/* no version of printf available */
-	static int gfmt(C* dst, size_t s, T val) noexcept;
+	static int gfmt(C* dst, size_t s, T val, unsigned precision) noexcept;
 };
 
 template<typename T, bool a, bool b>
 struct any_printf<wchar_t, T, true, a, b> {
 	static constexpr bool present = true;
-	static inline int gfmt(wchar_t* dst, size_t s, T val) noexcept {
-		return swprintf(dst, s, L"%.*g", config::write_double_precision,val);
+	static inline int gfmt(wchar_t* dst, size_t s, T val,
+			unsigned precision) noexcept {
+		return swprintf(dst, s, L"%.*g", precision, val);
 	}
 };
 template<typename T, bool a>
 struct any_printf<char, T, false, true, a> {
 	static constexpr bool present = true;
-	static inline int gfmt(char* dst, size_t s, T val) noexcept {
-		return snprintf(dst, s, "%.*g", config::write_double_precision, val);
+	static inline int gfmt(char* dst, size_t s, T val,
+			unsigned precision) noexcept {
+		return snprintf(dst, s, "%.*g", precision, val);
 	}
 };
 template<typename T>
 struct any_printf<char, T, false, false, true> {
 	static constexpr bool present = true;
-	static inline int gfmt(char* dst, size_t s, T val) noexcept {
-		return sprintf(dst, "%.*g", config::write_double_precision, val);
+	static inline int gfmt(char* dst, size_t, T val,
+			unsigned precision) noexcept {
+		return sprintf(dst, "%.*g", precision, val);
 	}
 };
 static constexpr bool with_sprintf =
@@ -126,7 +129,8 @@ template<typename C,
 	bool=with_sprintf && any_printf<C, double>::present,
 	bool=with_sprintf && any_printf<char, double>::present>
 struct any {
-	static inline bool gfmt(C* dst, size_t size, double val) noexcept;
+	static inline bool gfmt(C* dst, size_t size, double val,
+		unsigned precision) noexcept;
 //	static inline bool gfmt(C* dst, size_t size, double val) noexcept {
 //		int r = any_printf<C,double>::gfmt(dst, size, val);
 //		return r >= 0 && r < (int)size;
@@ -135,17 +139,19 @@ struct any {
 
 template<typename C, bool B>
 struct any<C,true,B> {
-	static inline bool gfmt(C* dst, size_t size, double val) noexcept {
-		int r = any_printf<C,double>::gfmt(dst, size, val);
+	static inline bool gfmt(C* dst, size_t size, double val,
+			unsigned precision) noexcept {
+		int r = any_printf<C,double>::gfmt(dst, size, val, precision);
 		return r >= 0 && r < (int)size;
 	}
 };
 
 template<typename C>
 struct any<C,false,true> {
-	static inline bool gfmt(C* dst, size_t size, double val) noexcept {
+	static inline bool gfmt(C* dst, size_t size, double val,
+			unsigned precision) noexcept {
 		char* tmp = reinterpret_cast<char*>(dst);
-		int r = any_printf<char,double>::gfmt(tmp, size, val);
+		int r = any_printf<char,double>::gfmt(tmp, size, val, precision);
 		if( r < 0 && r >= (int)size ) return false;
 		dst[r] = 0;
 		while( r-- ) dst[r] = tmp[r];
@@ -155,7 +161,8 @@ struct any<C,false,true> {
 
 template<typename C>
 struct any<C,false,false> {
-	static bool gfmt(C* dst, size_t size, double val) noexcept;
+	static bool gfmt(C* dst, size_t size, double val,
+		unsigned precision) noexcept;
 };
 
 
@@ -198,29 +205,62 @@ float exp_10<float>(short n) noexcept {
 	return exp10_helper<float>::calc(n);
 }
 template<config::write_double_impl_is = config::write_double_impl>
-static bool write_double_impl(const double& val, ostream& out) noexcept;
+struct write_double_impl;
 
 template<>
-inline bool write_double_impl<config::write_double_impl_is::internal>(
-		const double& val, ostream& out) noexcept {
-	return floating::serialize<ostream,config::write_double_integral_type>(
-			val, out, config::write_double_precision);
-}
+struct write_double_impl<config::write_double_impl_is::internal> {
+	/* fraction of the integral type holds one digit less than digits10	*/
+	static constexpr unsigned maxprecision =
+		std::numeric_limits<config::write_double_integral_type>::digits10 - 1;
+	static inline bool write(const double& val, ostream& out,
+			unsigned precision) noexcept {
+		return floating::serialize<ostream,config::write_double_integral_type>(
+			val, out, precision < maxprecision ? precision : maxprecision);
+	}
+};
 
 template<>
-inline bool write_double_impl<config::write_double_impl_is::with_sprintf>(
-		const double& val, ostream& out) noexcept {
-	temporary_s<char, config::sprintf_buffer_size,
-					  config::sprintf_buffer_static> tmp;
-	if( ! any<char>::gfmt(tmp, tmp.size, val) ) {
-		out.error(error_t::overrun);
-		return false;
+struct write_double_impl<config::write_double_impl_is::with_sprintf> {
+	static constexpr unsigned maxprecision =
+		std::numeric_limits<double>::digits10 + 2;
+	static inline bool write(const double& val, ostream& out,
+			unsigned precision) noexcept {
+		temporary_s<char, config::sprintf_buffer_size,
+						  config::sprintf_buffer_static> tmp;
+		if( ! any<char>::gfmt(tmp, tmp.size, val, precision) ) {
+			out.error(error_t::overrun);
+			return false;
+		}
+		return out.puts((const char*)tmp);
 	}
-	return out.puts((const char*)tmp);
-}
+};
 
 bool writer<double>::write(const double& val, ostream& out) noexcept {
-		return write_double_impl<>(val,out);
+	return write_double_impl<>::write(val, out, config::write_double_precision);
+}
+
+bool writer<double>::write(const double& val, ostream& out,
+		unsigned precision) noexcept {
+	return write_double_impl<>::write(val, out, precision);
+}
+
+/* Each candidate is written to a small buffer and read back with the
+ * reader<double>, the first one that matches is copied to out			*/
+bool writer<double>::shortest(const double& val, ostream& out) noexcept {
+	static constexpr unsigned maxprecision = write_double_impl<>::maxprecision;
+	char_t tmp[maxprecision + 10];
+	size_t n = 0;
+	for(unsigned precision = 1; precision <= maxprecision; ++precision) {
+		buffer dst(tmp, sizeof(tmp)/sizeof(tmp[0]));
+		if( ! write_double_impl<>::write(val, dst, precision) )
+			return writer<double>::write(val, out);
+		n = dst.count();
+		double back = 0;
+		buffer src(tmp, n);
+		lexer in(src);
+		if( reader<double>::read(back, in) && back == val ) break;
+	}
+	return out.putn(tmp, n);
 }
 
 }}
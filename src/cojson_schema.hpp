@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * cojson_schema.hpp - runtime-defined schemas. For host builds only
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+/*
+ * A schema maps a JSON object to a record in memory, described at run
+ * time as a list of fields: name, type and offset in the record.
+ * Fields may be scalars, in-place strings, nested objects with their own
+ * schema, or fixed-size arrays of scalars, strings or objects.
+ *
+ * schema::builder collects field descriptors, build() produces an
+ * immutable schema with the fields stored contiguously and an open
+ * addressing index of precomputed name hashes. Reading and writing go
+ * through the same collection algorithm as compile-time clas<C>, member
+ * names are looked up by hash instead of linear comparison.
+ *
+ * Nested schemas are referenced, not copied, and must outlive the schemas
+ * that refer to them.
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "cojson.hpp"
+
+namespace cojson {
+namespace details {
+
+/** type of a schema field or array element */
+enum class fieldtype : unsigned char {
+	boolean,
+	int8, int16, int32, int64,
+	uint8, uint16, uint32, uint64,
+	float32, float64,
+	string,	/* char_t buffer of given size in place		*/
+	object,	/* record described by a nested schema		*/
+	array	/* fixed number of elements of another type	*/
+};
+
+class schema {
+public:
+	struct field {
+		std::basic_string<char_t> name;
+		uint32_t hash;
+		fieldtype type;
+		fieldtype elemtype;	/* array element type					*/
+		size_t offset;		/* offset in the record					*/
+		size_t size;		/* string buffer size or array length	*/
+		size_t stride;		/* distance between array elements,
+							   buffer size for arrays of strings	*/
+		const schema* nested;
+	};
+	class builder;
+
+	bool read(void* obj, lexer& in) const noexcept {
+		return collection<indexer>::read(*this, obj, in);
+	}
+	bool write(const void* obj, ostream& out) const noexcept {
+		bool r = true;
+		for(size_t i = 0; i < fields.size() && r; ++i) {
+			r = object::dlm(i==0, out) &&
+				writer<const char_t*>::write(fields[i].name.c_str(), out) &&
+				out.put(literal::name_separator) &&
+				write(fields[i], fields[i].type, at(obj, fields[i].offset), out);
+		}
+		return r && (fields.size() || object::dlm(true, out)) &&
+				object::end(out);
+	}
+	/** returns field by name or nullptr if there is no such field */
+	const field* find(const char_t* name) const noexcept {
+		const uint32_t h = keyhash::of(name);
+		const size_t mask = index.size() - 1;
+		for(size_t i = h & mask, e; (e = index[i]) != 0; i = (i + 1) & mask) {
+			const field& f(fields[e-1]);
+			if( f.hash == h && match(f.name.c_str(), name) ) return &f;
+		}
+		return nullptr;
+	}
+	inline size_t size() const noexcept { return fields.size(); }
+	inline const field& operator[](size_t i) const noexcept {
+		return fields[i];
+	}
+	static inline constexpr bool null(void*) noexcept {
+		return not config::null_is_error;
+	}
+
+protected:
+	friend class collection<indexer>;
+	friend class collection<iterator>;
+	inline bool read(void* obj, lexer& in, const char_t* name) const noexcept {
+		const field* f = find(name);
+		if( f == nullptr ) return false;
+		read(*f, f->type, at(obj, f->offset), in);
+		return true;
+	}
+
+private:
+	/** array of a field, reads its elements through collection<> */
+	struct items {
+		const field& f;
+		static inline constexpr bool null(void*) noexcept {
+			return not config::null_is_error;
+		}
+		bool read(void* base, lexer& in, size_t i) const noexcept {
+			if( i < f.size )
+				return schema::read(f, f.elemtype, at(base, i * f.stride), in)
+					|| in.skip(false);
+			in.error(error_t::overrun);
+			return false;
+		}
+	};
+
+	template<typename T>
+	static inline T& as(void* p) noexcept { return *static_cast<T*>(p); }
+	template<typename T>
+	static inline const T& as(const void* p) noexcept {
+		return *static_cast<const T*>(p);
+	}
+	static inline void* at(void* p, size_t offset) noexcept {
+		return static_cast<unsigned char*>(p) + offset;
+	}
+	static inline const void* at(const void* p, size_t offset) noexcept {
+		return static_cast<const unsigned char*>(p) + offset;
+	}
+
+	static bool read(const field& f, fieldtype t, void* p,
+					 lexer& in) noexcept {
+		switch( t ) {
+		case fieldtype::boolean: return reader<bool>::read(as<bool>(p), in);
+		case fieldtype::int8:	 return reader<int8_t>::read(as<int8_t>(p), in);
+		case fieldtype::int16:	 return reader<int16_t>::read(as<int16_t>(p), in);
+		case fieldtype::int32:	 return reader<int32_t>::read(as<int32_t>(p), in);
+		case fieldtype::int64:	 return reader<int64_t>::read(as<int64_t>(p), in);
+		case fieldtype::uint8:	 return reader<uint8_t>::read(as<uint8_t>(p), in);
+		case fieldtype::uint16:	return reader<uint16_t>::read(as<uint16_t>(p), in);
+		case fieldtype::uint32:	return reader<uint32_t>::read(as<uint32_t>(p), in);
+		case fieldtype::uint64:	return reader<uint64_t>::read(as<uint64_t>(p), in);
+		case fieldtype::float32: return reader<float>::read(as<float>(p), in);
+		case fieldtype::float64: return reader<double>::read(as<double>(p), in);
+		case fieldtype::string:
+			return details::string(static_cast<char_t*>(p),
+					f.type == fieldtype::array ?
+						f.stride / sizeof(char_t) : f.size).read(in);
+		case fieldtype::object:
+			return f.nested->read(p, in);
+		case fieldtype::array:
+			return collection<>::read(items { f }, p, in);
+		}
+		return false;
+	}
+
+	static bool write(const field& f, fieldtype t, const void* p,
+					  ostream& out) noexcept {
+		switch( t ) {
+		case fieldtype::boolean: return writer<bool>::write(as<bool>(p), out);
+		case fieldtype::int8:	return writer<int8_t>::write(as<int8_t>(p), out);
+		case fieldtype::int16:	return writer<int16_t>::write(as<int16_t>(p), out);
+		case fieldtype::int32:	return writer<int32_t>::write(as<int32_t>(p), out);
+		case fieldtype::int64:	return writer<int64_t>::write(as<int64_t>(p), out);
+		case fieldtype::uint8:	return writer<uint8_t>::write(as<uint8_t>(p), out);
+		case fieldtype::uint16: return writer<uint16_t>::write(as<uint16_t>(p),out);
+		case fieldtype::uint32: return writer<uint32_t>::write(as<uint32_t>(p),out);
+		case fieldtype::uint64: return writer<uint64_t>::write(as<uint64_t>(p),out);
+		case fieldtype::float32: return writer<float>::write(as<float>(p), out);
+		case fieldtype::float64: return writer<double>::write(as<double>(p), out);
+		case fieldtype::string:
+			return writer<const char_t*>::write(static_cast<const char_t*>(p), out);
+		case fieldtype::object:
+			return f.nested->write(p, out);
+		case fieldtype::array: {
+			bool r = true;
+			for(size_t i = 0; i < f.size && r; ++i)
+				r = array::dlm(i==0, out) &&
+					write(f, f.elemtype, at(p, i * f.stride), out);
+			return r && (f.size || array::dlm(true, out)) && array::end(out);
+		}
+		}
+		return false;
+	}
+
+	std::vector<field> fields;
+	std::vector<size_t> index;
+};
+
+/**
+ * Collects field descriptors and builds an immutable schema
+ */
+class schema::builder {
+public:
+	/** scalar field of type t at offset */
+	builder& scalar(const char_t* name, fieldtype t, size_t offset) {
+		return add(name, t, t, offset, sizeof_(t), 0, nullptr);
+	}
+	/** char_t[size] string field at offset */
+	builder& string(const char_t* name, size_t offset, size_t size) {
+		return add(name, fieldtype::string, fieldtype::string, offset, size,
+				0, nullptr);
+	}
+	/** nested object field at offset */
+	builder& object(const char_t* name, size_t offset, const schema& s) {
+		return add(name, fieldtype::object, fieldtype::object, offset, 0, 0,
+				&s);
+	}
+	/** array of count scalars of type t at offset */
+	builder& array(const char_t* name, fieldtype t, size_t offset,
+			size_t count, size_t stride = 0) {
+		return add(name, fieldtype::array, t, offset, count,
+				stride ? stride : sizeof_(t), nullptr);
+	}
+	/** array of count strings of char_t[size] at offset */
+	builder& strings(const char_t* name, size_t offset, size_t count,
+			size_t size) {
+		return add(name, fieldtype::array, fieldtype::string, offset,
+				count, size * sizeof(char_t), nullptr);
+	}
+	/** array of count objects stride bytes apart at offset */
+	builder& objects(const char_t* name, size_t offset, size_t count,
+			size_t stride, const schema& s) {
+		return add(name, fieldtype::array, fieldtype::object, offset, count,
+				stride, &s);
+	}
+
+	/** builds the schema, fields are written in the order of adding */
+	schema build() const {
+		schema s;
+		s.fields = fields;
+		size_t n = 1;
+		while( n < fields.size() + fields.size() / 3 + 1 ) n <<= 1;
+		s.index.assign(n, 0);
+		for(size_t e = 0; e < s.fields.size(); ++e) {
+			size_t i = s.fields[e].hash & (n - 1);
+			while( s.index[i] ) i = (i + 1) & (n - 1);
+			s.index[i] = e + 1;
+		}
+		return s;
+	}
+private:
+	builder& add(const char_t* name, fieldtype t, fieldtype e, size_t offset,
+			size_t size, size_t stride, const schema* nested) {
+		fields.push_back(field { name, keyhash::of(name), t, e, offset,
+			size, stride, nested });
+		return *this;
+	}
+	static constexpr size_t sizeof_(fieldtype t) noexcept {
+		return
+			t == fieldtype::boolean ? sizeof(bool) :
+			t == fieldtype::int8  || t == fieldtype::uint8  ? 1 :
+			t == fieldtype::int16 || t == fieldtype::uint16 ? 2 :
+			t == fieldtype::int32 || t == fieldtype::uint32 ? 4 :
+			t == fieldtype::int64 || t == fieldtype::uint64 ? 8 :
+			t == fieldtype::float32 ? sizeof(float) :
+			t == fieldtype::float64 ? sizeof(double) : 0;
+	}
+	std::vector<field> fields;
+};
+
+} /* namespace details */
+using fieldtype = details::fieldtype;
+using schema = details::schema;
+}
@@ -0,0 +1,390 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * cojson_stdlib.hpp - readers, writers and accessors for C++ standard
+ * library containers. For host builds only
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ * This file is part of µcuREST Library. http://hutorny.in.ua/projects/micurest
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+/*
+ * std::basic_string, std::vector and std::optional (C++17) are mapped with
+ * reader/writer specializations, so they work with every scalar accessor,
+ * P<> and V<>. Vectors of objects are mapped with accessor::container and
+ * V<X,S>, or with P<C,id,T,&C::vector,S>.
+ *
+ * Reading reuses elements already present in a vector and the capacity of
+ * strings and vectors, so repeated reads of similar documents do not
+ * reallocate. Excessive elements are erased after the read.
+ *
+ * stddictionary<T> maps JSON objects with dynamic keys to a growable hash
+ * table, see also fixed capacity dictionary<T,N,K> in cojson.hpp
+ *
+ * Containers may allocate from a per-request details::arena via
+ * arena_allocator; arena memory is released at once by arena::reset(),
+ * after all the containers using it are gone.
+ *
+ * Allocation failures throw std::bad_alloc from noexcept functions,
+ * which terminates the program.
+ */
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#if __cplusplus >= 201703L
+#	include <optional>
+#endif
+#include "cojson.hpp"
+
+namespace cojson {
+namespace details {
+
+/**
+ * STL allocator over a scratch arena, falls back to std::allocator
+ * when the arena is not given or exhausted
+ */
+template<typename T>
+struct arena_allocator {
+	typedef T value_type;
+	inline arena_allocator(arena* mem = nullptr) noexcept : memory(mem) {}
+	template<typename U>
+	inline arena_allocator(const arena_allocator<U>& a) noexcept
+	  : memory(a.memory) {}
+	T* allocate(std::size_t n) {
+		T* p = memory != nullptr && n <= memory->available() / sizeof(T) ?
+				memory->template allocate<T>(n) : nullptr;
+		return p != nullptr ? p : std::allocator<T>().allocate(n);
+	}
+	void deallocate(T* p, std::size_t n) noexcept {
+		/* arena memory is released all at once */
+		if( memory == nullptr || ! memory->owns(p) )
+			std::allocator<T>().deallocate(p, n);
+	}
+	arena* memory;
+};
+
+template<typename T, typename U>
+inline bool operator==(const arena_allocator<T>& a,
+					   const arena_allocator<U>& b) noexcept {
+	return a.memory == b.memory;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const arena_allocator<T>& a,
+					   const arena_allocator<U>& b) noexcept {
+	return a.memory != b.memory;
+}
+
+/**
+ * reads/writes a JSON array from/to a std::vector
+ * items are read/written with IO::read(T&,lexer&,trail&) and
+ * IO::write(const T&,ostream&), trail keeps the member order across items
+ */
+template<class V, class IO>
+struct stdarray {
+	struct state {
+		V& vec;
+		size_t count;
+		trail order;
+	};
+	static bool read(V& vec, lexer& in) noexcept {
+		state st { vec, 0, {} };
+		bool r = collection<>::read(stdarray(), st, in);
+		if( st.count < vec.size() )
+			vec.erase(vec.begin() + st.count, vec.end());
+		return r;
+	}
+	static bool write(const V& vec, ostream& out) noexcept {
+		if( vec.empty() )
+			return array::dlm(true, out) && array::end(out);
+		bool r = true;
+		for(size_t i = 0; i < vec.size() && r; ++i)
+			r = array::dlm(i==0, out) && IO::write(vec[i], out);
+		return r && array::end(out);
+	}
+	/** null clears the vector */
+	inline bool null(state&) const noexcept {
+		return not config::null_is_error;
+	}
+	/** read item, reusing the existing element if any */
+	inline bool read(state& st, lexer& in, size_t i) const noexcept {
+		if( i >= st.vec.size() )
+			st.vec.emplace_back();
+		st.count = i + 1;
+		return IO::read(st.vec[i], in, st.order) || in.skip(false);
+	}
+};
+
+/**
+ * item reader/writer for objects structured with S
+ */
+template<typename T, const clas<T>& (*S)() noexcept>
+struct clasio {
+	static inline bool read(T& obj, lexer& in, trail& order) noexcept {
+		return S().read(obj, in, order);
+	}
+	static inline bool write(const T& obj, ostream& out) noexcept {
+		return S().write(obj, out);
+	}
+};
+
+/**
+ * item reader/writer for scalars
+ */
+template<typename T>
+struct scalario {
+	static inline bool read(T& val, lexer& in, trail&) noexcept {
+		return reader<T>::read(val, in);
+	}
+	static inline bool write(const T& val, ostream& out) noexcept {
+		return writer<T>::write(val, out);
+	}
+};
+
+template<class Tr, class A>
+struct reader<std::basic_string<char_t, Tr, A>, false> {
+	static bool read(std::basic_string<char_t, Tr, A>& dst,
+					 lexer& in) noexcept {
+		ctype ct;
+		char_t chr;
+		bool first = true;
+		if( ! isvalid(ct=in.value(ctype::stringnull)) )
+			return in.skip();
+		dst.clear(); /* keeps capacity */
+		if( ct == ctype::null ) return true;
+		while( (ct=in.string(chr, first)) == ctype::string ) {
+			dst.push_back(chr);
+			first = false;
+		}
+		if( ct == ctype::delim || ct == ctype::eof ) return true;
+		in.error(error_t::bad);
+		return false;
+	}
+};
+
+template<class Tr, class A>
+struct writer<std::basic_string<char_t, Tr, A>, false> {
+	static bool write(const std::basic_string<char_t, Tr, A>& str,
+					  ostream& out) noexcept {
+		bool r = true;
+		if( ! out.put(literal::quotation_mark) ) return false;
+		for(size_t i = 0; i < str.size() && r; ++i)
+			r = writer<const char_t*>::write(str[i], out);
+		return r && out.put(literal::quotation_mark);
+	}
+};
+
+template<typename T, class A>
+struct reader<std::vector<T, A>, false> {
+	static inline bool read(std::vector<T, A>& dst, lexer& in) noexcept {
+		return stdarray<std::vector<T, A>, scalario<T>>::read(dst, in);
+	}
+};
+
+template<typename T, class A>
+struct writer<std::vector<T, A>, false> {
+	static inline bool write(const std::vector<T, A>& v,
+							 ostream& out) noexcept {
+		return stdarray<std::vector<T, A>, scalario<T>>::write(v, out);
+	}
+};
+
+#if __cplusplus >= 201703L
+template<typename T>
+struct reader<std::optional<T>, false> {
+	/** null resets the optional, any other value is read into it */
+	static bool read(std::optional<T>& dst, lexer& in) noexcept {
+		char_t chr;
+		if( ! in.skipws(chr) ) return false;
+		in.back(chr);
+		if( lexer::is_null(chr) ) {
+			dst.reset();
+			return isvalid(in.value(ctype::null));
+		}
+		if( ! dst ) dst.emplace();
+		return reader<T>::read(*dst, in);
+	}
+};
+
+template<typename T>
+struct writer<std::optional<T>, false> {
+	static inline bool write(const std::optional<T>& v,
+							 ostream& out) noexcept {
+		return v ? writer<T>::write(*v, out) : value::null(out);
+	}
+};
+#endif
+
+/**
+ * growable storage for hashmap, keys are kept in std::basic_string,
+ * the slot index doubles when the load factor reaches 3/4
+ */
+template<typename T>
+class stdmap {
+public:
+	typedef T value_type;
+	inline stdmap() : index(8) {}
+	inline size_t count() const noexcept { return entries.size(); }
+	inline const char_t* key(size_t i) const noexcept {
+		return entries[i].key.c_str();
+	}
+protected:
+	inline T& value(size_t i) noexcept { return entries[i].value; }
+	inline uint32_t hash(size_t i) const noexcept { return entries[i].hash; }
+	inline size_t slots() const noexcept { return index.size(); }
+	inline size_t& slot(size_t i) noexcept { return index[i]; }
+	inline size_t slot(size_t i) const noexcept { return index[i]; }
+	inline bool stage(size_t n, char_t chr) noexcept {
+		if( n == 0 ) next.clear();
+		if( chr ) next.push_back(chr);
+		return true;
+	}
+	inline const char_t* staged() const noexcept { return next.c_str(); }
+	inline bool crowded() const noexcept {
+		return (entries.size() + 1) * 4 > index.size() * 3;
+	}
+	inline bool grow() noexcept {
+		index.resize(index.size() * 2);
+		return true;
+	}
+	inline size_t append(uint32_t h) noexcept {
+		entries.push_back(entry { T(), h, static_cast<key_t&&>(next) });
+		return entries.size() - 1;
+	}
+	inline void clear() noexcept { entries.clear(); }
+private:
+	typedef std::basic_string<char_t> key_t;
+	struct entry {
+		T value;
+		uint32_t hash;
+		key_t key;
+	};
+	std::vector<entry> entries;
+	std::vector<size_t> index;
+	key_t next;
+};
+
+} /* namespace details */
+
+using details::arena_allocator;
+/** dictionary with unlimited number of keys */
+template<typename T>
+using stddictionary = details::hashmap<details::stdmap<T>>;
+
+template<typename T>
+using arena_vector = std::vector<T, arena_allocator<T>>;
+typedef std::basic_string<char_t, std::char_traits<char_t>,
+		arena_allocator<char_t>> arena_string;
+
+namespace accessor {
+/**
+ * Accessor for items of a growable container V (std::vector) via function
+ * returning reference to the container. Reading appends items and reads
+ * them in place, reusing existing ones
+ */
+template<class V, V& (*G)() noexcept>
+struct container {
+	typedef typename V::value_type T;
+	typedef T clas;
+	typedef T type;
+	static constexpr bool canget = true;
+	static constexpr bool canset = true;
+	static constexpr bool canlref   = true;
+	static constexpr bool canrref   = true;
+	static constexpr bool is_vector = true;
+	static inline bool has(size_t i) noexcept { return i < G().size(); }
+	static inline const T& get(size_t i) noexcept { return G()[i]; }
+	static inline T& lref(size_t i) noexcept { return G()[i]; }
+	static inline const T& rref(size_t i) noexcept { return G()[i]; }
+	static inline void set(size_t i, const T& v) noexcept {
+		if( i < G().size() ) G()[i] = v;
+		else G().push_back(v);
+	}
+	static inline void init(T&) noexcept {}
+	static inline constexpr bool null(void_t) noexcept {
+		return not config::null_is_error;
+	}
+	static inline V& items() noexcept { return G(); }
+private:
+	container();
+};
+} /* namespace accessor */
+
+namespace details {
+
+/**
+ * vector of scalars in a growable container
+ */
+template<class V, V& (*G)() noexcept>
+struct values<accessor::container<V,G>> : value {
+	typedef scalario<typename V::value_type> IO;
+	bool read(lexer& in) const noexcept {
+		return stdarray<V, IO>::read(G(), in);
+	}
+	bool write(ostream& out) const noexcept {
+		return stdarray<V, IO>::write(G(), out);
+	}
+	/** container is always written, even if empty */
+	static inline constexpr bool has() noexcept { return true; }
+};
+
+/**
+ * vector of objects in a growable container
+ */
+template<class V, V& (*G)() noexcept,
+	const clas<typename accessor::container<V,G>::type>& (*S)() noexcept>
+struct objects<accessor::container<V,G>, S> : value {
+	typedef clasio<typename V::value_type, S> IO;
+	bool read(lexer& in) const noexcept {
+		return stdarray<V, IO>::read(G(), in);
+	}
+	bool write(ostream& out) const noexcept {
+		return stdarray<V, IO>::write(G(), out);
+	}
+};
+
+/** PropertyVectorOfObjects
+ * nested in C std::vector of objects of type T with structure S
+ */
+template<class C, details::name id, class T,
+	std::vector<T> C::*V, const details::clas<T>& S()>
+inline const details::property<C> & PropertyVectorOfObjects() noexcept {
+	typedef stdarray<std::vector<T>, clasio<T, S>> A;
+	static const struct local : details::property<C> {
+		cstring name() const noexcept { return id(); }
+		bool read(C& obj, details::lexer& in) const noexcept {
+			return A::read(obj.*V, in);
+		}
+		bool write(const C& obj, details::ostream& out) const noexcept {
+			return A::write(obj.*V, out);
+		}
+	} l;
+	return l;
+}
+} /* namespace details */
+
+/**
+ * nested in C std::vector of objects of type T with structure S
+ */
+template<class C, details::name id, class T,
+	std::vector<T> C::*V, const details::clas<T>& S()>
+const details::property<C> & P() noexcept {
+	return details::PropertyVectorOfObjects<C,id,T,V,S>();
+}
+
+}
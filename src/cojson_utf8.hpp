@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * cojson_utf8.hpp - UTF-8 transcoding stream adapters for builds with
+ * wide char_t (char16_t, char32_t, wchar_t)
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+/*
+ * utf8istream decodes UTF-8 octets, from a contiguous buffer or from an
+ * octetsource, into blocks of char_t and feeds the lexer from the block.
+ * utf8ostream encodes char_t into a block of UTF-8 octets and passes full
+ * blocks to an octetsink (see cojson.hpp).
+ * char_t of two octets is treated as UTF-16, wider one - as UTF-32.
+ * Runs of ASCII are detected and widened eight octets at a time (SWAR).
+ * Invalid, overlong, surrogate or truncated sequences set error_t::bad
+ */
+
+#pragma once
+#include <string.h>
+#include "cojson.hpp"
+
+namespace cojson {
+namespace details {
+
+static_assert(sizeof(char_t) > 1,
+	"UTF-8 adapters are intended for builds with wide char_t");
+
+/**
+ * Source of UTF-8 octets for utf8istream
+ */
+struct octetsource {
+	/** reads up to n octets into dst, returns number of octets read,
+	 *  0 at the end of data												*/
+	virtual size_t read(unsigned char* dst, size_t n) noexcept = 0;
+};
+
+namespace utf8 {
+enum class status { ok, partial, invalid };
+
+/** returns true if all eight octets at p are ASCII						*/
+static inline bool ascii8(const unsigned char* p) noexcept {
+	uint64_t w;
+	memcpy(&w, p, sizeof(w));
+	return (w & 0x8080808080808080ULL) == 0;
+}
+
+/**
+ * decodes octets src[i..n) into code units dst[o..m), advancing i and o.
+ * Stops when the output is full, on an invalid sequence, or on an
+ * incomplete sequence at the end of the input (partial)
+ */
+template<typename T>
+status decode(const unsigned char* src, size_t& i, size_t n,
+			  T* dst, size_t& o, size_t m) noexcept {
+	while( i < n && o < m ) {
+		if( i + 8 <= n && o + 8 <= m && ascii8(src + i) ) {
+			for(size_t k = 0; k < 8; ++k) dst[o+k] = src[i+k];
+			i += 8;
+			o += 8;
+			continue;
+		}
+		uint32_t cp = src[i];
+		if( cp < 0x80 ) {
+			dst[o++] = static_cast<T>(cp);
+			++i;
+			continue;
+		}
+		size_t len;
+		uint32_t min;
+		if( (cp & 0xE0) == 0xC0 ) { len = 2; cp &= 0x1F; min = 0x80;    } else
+		if( (cp & 0xF0) == 0xE0 ) { len = 3; cp &= 0x0F; min = 0x800;   } else
+		if( (cp & 0xF8) == 0xF0 ) { len = 4; cp &= 0x07; min = 0x10000; } else
+			return status::invalid;
+		for(size_t k = 1; k < len; ++k) {
+			if( i + k >= n ) return status::partial;
+			if( (src[i+k] & 0xC0) != 0x80 ) return status::invalid;
+			cp = (cp << 6) | (src[i+k] & 0x3F);
+		}
+		if( cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF) )
+			return status::invalid;
+		if( sizeof(T) == 2 && cp >= 0x10000 ) {
+			if( o + 2 > m ) break;
+			cp -= 0x10000;
+			dst[o++] = static_cast<T>(0xD800 + (cp >> 10));
+			dst[o++] = static_cast<T>(0xDC00 + (cp & 0x3FF));
+		} else
+			dst[o++] = static_cast<T>(cp);
+		i += len;
+	}
+	return status::ok;
+}
+
+/** encodes code point cp into dst, returns number of octets written	*/
+static inline size_t encode(uint32_t cp, unsigned char* dst) noexcept {
+	if( cp < 0x80 ) {
+		dst[0] = cp;
+		return 1;
+	}
+	if( cp < 0x800 ) {
+		dst[0] = 0xC0 | (cp >> 6);
+		dst[1] = 0x80 | (cp & 0x3F);
+		return 2;
+	}
+	if( cp < 0x10000 ) {
+		dst[0] = 0xE0 | (cp >> 12);
+		dst[1] = 0x80 | ((cp >> 6) & 0x3F);
+		dst[2] = 0x80 | (cp & 0x3F);
+		return 3;
+	}
+	dst[0] = 0xF0 | (cp >> 18);
+	dst[1] = 0x80 | ((cp >> 12) & 0x3F);
+	dst[2] = 0x80 | ((cp >> 6) & 0x3F);
+	dst[3] = 0x80 | (cp & 0x3F);
+	return 4;
+}
+} /* namespace utf8 */
+
+/**
+ * Input stream decoding UTF-8 into char_t
+ */
+class utf8istream : public istream {
+public:
+	static constexpr size_t block = 64;
+	/** decodes a contiguous UTF-8 buffer of n octets					*/
+	inline utf8istream(const char* utf8, size_t n) noexcept
+	  : source(nullptr),
+		data(reinterpret_cast<const unsigned char*>(utf8)),
+		size(n), offset(0), pos(0), len(0) {}
+	/** decodes UTF-8 octets read from src in blocks					*/
+	inline utf8istream(octetsource& src) noexcept
+	  : source(&src), data(raw), size(0), offset(0), pos(0), len(0) {}
+
+	bool get(char_t& c) noexcept {
+		if( pos < len ) {
+			c = units[pos++];
+			return true;
+		}
+		return fill(c);
+	}
+private:
+	bool fill(char_t& c) noexcept {
+		pos = len = 0;
+		for(;;) {
+			utf8::status st =
+				utf8::decode(data, offset, size, units, len, block);
+			if( len ) break;
+			if( st == utf8::status::invalid ) return fail(c);
+			if( source == nullptr ) return offset < size ? fail(c) : eof(c);
+			/* carry an incomplete sequence over to the next block */
+			const size_t carry = size - offset;
+			memmove(raw, raw + offset, carry);
+			const size_t n = source->read(raw + carry, sizeof(raw) - carry);
+			if( n == 0 ) return carry ? fail(c) : eof(c);
+			size = carry + n;
+			offset = 0;
+		}
+		c = units[pos++];
+		return true;
+	}
+	inline bool fail(char_t& c) noexcept {
+		c = iostate::err_c;
+		error(error_t::bad);
+		return false;
+	}
+	inline bool eof(char_t& c) noexcept {
+		c = iostate::eos_c;
+		error(error_t::eof);
+		return false;
+	}
+	octetsource* const source;
+	const unsigned char* data;
+	size_t size;
+	size_t offset;
+	size_t pos;
+	size_t len;
+	char_t units[block];
+	unsigned char raw[block];
+};
+
+/**
+ * Output stream encoding char_t into UTF-8
+ * Octets are passed to the sink by blocks, call flush() at the end
+ */
+class utf8ostream : public ostream {
+public:
+	static constexpr size_t block = 64;
+	inline utf8ostream(octetsink& dst) noexcept
+	  : sink(dst), len(0), high(0) {}
+
+	bool put(char_t c) noexcept {
+		uint32_t cp =
+			static_cast<typename std::make_unsigned<char_t>::type>(c);
+		if( sizeof(char_t) == 2 ) {
+			if( high ) {
+				if( cp < 0xDC00 || cp > 0xDFFF ) return fail();
+				cp = 0x10000 + ((high - 0xD800) << 10) + (cp - 0xDC00);
+				high = 0;
+			} else if( cp >= 0xD800 && cp <= 0xDBFF ) {
+				high = cp;
+				return true;
+			}
+		}
+		if( cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF) ) return fail();
+		if( len + 4 > block && ! flush() ) return false;
+		len += utf8::encode(cp, raw + len);
+		return true;
+	}
+	/** passes encoded octets to the sink								*/
+	bool flush() noexcept {
+		if( high ) return fail();
+		if( len == 0 ) return true;
+		const size_t n = len;
+		len = 0;
+		if( sink.write(raw, n) ) return true;
+		error(error_t::ioerror);
+		return false;
+	}
+private:
+	inline bool fail() noexcept {
+		high = 0;
+		error(error_t::bad);
+		return false;
+	}
+	octetsink& sink;
+	size_t len;
+	uint32_t high;
+	unsigned char raw[block];
+};
+
+} /* namespace details */
+using utf8istream = details::utf8istream;
+using utf8ostream = details::utf8ostream;
+using octetsource = details::octetsource;
+}
@@ -1,8 +1,24 @@
 /**
  *  Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
  *  zero-dependency allocation free mapping of enum values to names
+ *
+ *  names<T, L...> looks up a name by a perfect hash and a key by a dense
+ *  index, both generated at compile time. Lookup falls back to linear
+ *  search with match() when no perfect hash is found (e.g. duplicate names)
+ *  or keys are too sparse for an index.
+ *  Names must be constexpr functions, the hash assumes that match()
+ *  compares names exactly. On AVR the tables are placed in progmem, which
+ *  is not readable in constant expressions, so lookups by key and by index
+ *  use linear search there.
  */
 #pragma once
+#if defined(__AVR__)
+#	include <avr/pgmspace.h>
+#	define ENUMNAMES_ROM __attribute__((progmem))
+#else
+#	define ENUMNAMES_ROM
+#endif
+
 namespace enumnames {
 
 typedef const char* (*name)();
@@ -45,19 +61,263 @@ struct map<L,R...> {
 	}
 };
 
+namespace details {
+
+#if defined(__AVR__)
+static constexpr bool progmem = true;
+
+/** reads an element of a constant table */
+template<typename T>
+static inline T rom(const T* p) noexcept {
+	T v;
+	memcpy_P(&v, p, sizeof(T));
+	return v;
+}
+#else
+static constexpr bool progmem = false;
+
+/** reads an element of a constant table */
+template<typename T>
+static inline constexpr T rom(const T* p) noexcept {
+	return *p;
+}
+#endif
+
+/** FNV-1a hash h continued with characters of s */
+static inline constexpr unsigned long fnv(unsigned long h,
+		const char* s) noexcept {
+	return *s ? fnv((h ^ static_cast<unsigned char>(*s)) * 16777619ul, s + 1)
+		: h;
+}
+
+/** seeded FNV-1a hash of a name */
+static inline constexpr unsigned long hash(unsigned long seed,
+		const char* s) noexcept {
+	return fnv(2166136261ul ^ seed, s);
+}
+
+static inline constexpr unsigned pow2(unsigned n, unsigned p = 1) noexcept {
+	return p < n ? pow2(n, p << 1) : p;
+}
+
+/* index sequence for generating tables */
+template<unsigned long ... I>
+struct indices {};
+
+template<class A, class B>
+struct concat;
+
+template<unsigned long ... I, unsigned long ... J>
+struct concat<indices<I...>, indices<J...>> {
+	typedef indices<I..., (sizeof...(I) + J)...> type;
+};
+
+template<unsigned long N>
+struct make_indices {
+	typedef typename concat<typename make_indices<N / 2>::type,
+		typename make_indices<N - N / 2>::type>::type type;
+};
+
+template<>
+struct make_indices<0> {
+	typedef indices<> type;
+};
+
+template<>
+struct make_indices<1> {
+	typedef indices<0> type;
+};
+
+/** hashes of N names with a seed, null names hash to 0 */
+template<unsigned N>
+struct digest {
+	unsigned long h[N];
+	constexpr digest(const char* const (&names)[N], unsigned long seed)
+	  noexcept : digest(names, seed, typename make_indices<N>::type()) {}
+	template<unsigned long ... I>
+	constexpr digest(const char* const (&names)[N], unsigned long seed,
+		indices<I...>) noexcept
+	  : h{ (names[I] != nullptr ? hash(seed, names[I]) : 0)... } {}
+};
+
+/** seed and size of a table with no collisions of N names */
+template<unsigned N>
+struct perfect {
+	static constexpr unsigned maxseed = 256;
+	static constexpr unsigned maxsize = 4 * pow2(N);
+	unsigned long seed;
+	unsigned size; /* 0 if not found */
+
+	constexpr perfect(const char* const (&names)[N]) noexcept
+	  : perfect(find(names, pow2(N))) {}
+private:
+	typedef const char* const (&names_t)[N];
+	constexpr perfect(unsigned long k, unsigned s) noexcept
+	  : seed(k), size(s) {}
+	/* tables of size s and larger, with the first fitting seed			*/
+	static constexpr perfect find(names_t names, unsigned s) noexcept {
+		return s > maxsize ? perfect(0, 0) :
+			found(names, s, first(names, s, 0, maxseed));
+	}
+	static constexpr perfect found(names_t names, unsigned s,
+			unsigned long k) noexcept {
+		return k < maxseed ? perfect(k, s) : find(names, s << 1);
+	}
+	/* first seed in [lo, hi) with no collisions, maxseed if none		*/
+	static constexpr unsigned long first(names_t names, unsigned s,
+			unsigned long lo, unsigned long hi) noexcept {
+		return hi - lo > 1 ?
+			either(first(names, s, lo, (lo + hi) / 2), names, s,
+				(lo + hi) / 2, hi) :
+			place(names, digest<N>(names, lo), s - 1, 0, taken()) ?
+				lo : maxseed;
+	}
+	static constexpr unsigned long either(unsigned long k, names_t names,
+			unsigned s, unsigned long lo, unsigned long hi) noexcept {
+		return k < maxseed ? k : first(names, s, lo, hi);
+	}
+	/* slots taken by names placed so far, a bit per slot					*/
+	struct taken {
+		static constexpr unsigned words = (maxsize + 63) / 64;
+		unsigned long long w[words];
+		constexpr taken() noexcept : w{} {}
+		template<unsigned long ... I>
+		constexpr taken(const taken& t, unsigned long k, indices<I...>)
+		  noexcept : w{ (I == k / 64 ? t.w[I] | 1ull << (k % 64) : t.w[I])... } {}
+		constexpr bool has(unsigned long k) const noexcept {
+			return (w[k / 64] >> (k % 64)) & 1;
+		}
+		constexpr taken with(unsigned long k) const noexcept {
+			return taken(*this, k, typename make_indices<words>::type());
+		}
+	};
+	/* names from i on fit in slots not taken yet							*/
+	static constexpr bool place(names_t names, const digest<N>& d,
+			unsigned long mask, unsigned i, const taken& t) noexcept {
+		return i == N || (names[i] == nullptr ?
+			place(names, d, mask, i + 1, t) :
+			! t.has(d.h[i] & mask) &&
+			place(names, d, mask, i + 1, t.with(d.h[i] & mask)));
+	}
+};
+
+/** name index by hash, an entry is name's index + 1, or 0 */
+template<unsigned N, unsigned S>
+struct slots {
+	unsigned char slot[S ? S : 1];
+	constexpr slots(const char* const (&names)[N], unsigned long seed)
+	  noexcept : slots(names, digest<N>(names, seed),
+			typename make_indices<S>::type()) {}
+	template<unsigned long ... I>
+	constexpr slots(const char* const (&names)[N], const digest<N>& d,
+		indices<I...>) noexcept : slot{ at(names, d, I, 0)... } {}
+	/* first name from i on hashed to slot j								*/
+	static constexpr unsigned char at(const char* const (&names)[N],
+			const digest<N>& d, unsigned long j, unsigned i) noexcept {
+		return i == N ? 0 :
+			names[i] != nullptr && (d.h[i] & (S - 1)) == j ? i + 1 :
+			at(names, d, j, i + 1);
+	}
+};
+
+/** dense index of keys, an entry is index of the first key's name + 1 */
+template<unsigned N, unsigned long R>
+struct keyindex {
+	unsigned char entry[R ? R : 1];
+	constexpr keyindex(const long (&keys)[N], long min) noexcept
+	  : keyindex(keys, min, typename make_indices<R>::type()) {}
+	template<unsigned long ... I>
+	constexpr keyindex(const long (&keys)[N], long min, indices<I...>)
+	  noexcept : entry{ at(keys, min + static_cast<long>(I), 0)... } {}
+	/* first key from i on equal to k										*/
+	static constexpr unsigned char at(const long (&keys)[N], long k,
+			unsigned i) noexcept {
+		return i == N ? 0 : keys[i] == k ? i + 1 : at(keys, k, i + 1);
+	}
+};
+
+static inline constexpr long least(long a, long b) noexcept {
+	return a < b ? a : b;
+}
+
+static inline constexpr long most(long a, long b) noexcept {
+	return a > b ? a : b;
+}
+
+template<unsigned N>
+static inline constexpr long lowest(const long (&keys)[N],
+		unsigned i = 0) noexcept {
+	return i + 1 < N ? least(keys[i], lowest(keys, i + 1)) : keys[i];
+}
+
+template<unsigned N>
+static inline constexpr long highest(const long (&keys)[N],
+		unsigned i = 0) noexcept {
+	return i + 1 < N ? most(keys[i], highest(keys, i + 1)) : keys[i];
+}
+}
+
 template<typename T, typename ... L>
 struct names {
 	typedef T type;
 	static T get(const char* nam) noexcept {
+		if( hashed ) {
+			const unsigned i = details::rom(&hashes.slot[
+				details::hash(perfect.seed, nam) & (perfect.size - 1)]);
+			return i && match(nam, details::rom(&strs[i-1])) ?
+				details::rom(&keys[i-1]) : details::rom(&keys[count-1]);
+		}
 		return M::get(nam);
 	}
 	static constexpr const char* get(T key) noexcept {
-		return M::get(key);
+		return indexed ? entry(static_cast<long>(key) - lo) : M::get(key);
 	}
 	static constexpr const char* get(unsigned i) noexcept {
-		return M::get(i);
+		return details::progmem ? M::get(i) :
+			i < count ? details::rom(&strs[i]) : nullptr;
 	}
 private:
 	typedef map<L...> M;
+	/* name of the key at k in the index, or empty */
+	static constexpr const char* entry(long k) noexcept {
+		return named(k >= 0 && k < range ? details::rom(&index.entry[k]) : 0);
+	}
+	static constexpr const char* named(unsigned i) noexcept {
+		return i && details::rom(&strs[i-1]) != nullptr ?
+			details::rom(&strs[i-1]) : "";
+	}
+	static constexpr unsigned count = sizeof...(L);
+	static_assert(count > 0 && count < 255, "Unsupported number of names");
+
+	static constexpr const char* const strs[count] ENUMNAMES_ROM {
+		(L::val != nullptr ? L::val() : nullptr)... };
+	static constexpr T keys[count] ENUMNAMES_ROM { L::key... };
+
+	static constexpr details::perfect<count> perfect { strs };
+	static constexpr bool hashed = perfect.size != 0;
+	static constexpr details::slots<count, perfect.size> hashes ENUMNAMES_ROM
+		{ strs, perfect.seed };
+
+	static constexpr long values[count] { static_cast<long>(L::key)... };
+	static constexpr long lo = details::lowest(values);
+	/* keys are indexed if they span no more than twice the number of names */
+	static constexpr long range = details::highest(values) - lo + 1;
+	static constexpr bool indexed =
+		! details::progmem && range <= 2 * count + 2;
+	static constexpr details::keyindex<count, indexed ? range : 0>
+		index ENUMNAMES_ROM { values, lo };
 };
+
+template<typename T, typename ... L>
+constexpr const char* const names<T, L...>::strs[];
+template<typename T, typename ... L>
+constexpr T names<T, L...>::keys[];
+template<typename T, typename ... L>
+constexpr details::perfect<names<T, L...>::count> names<T, L...>::perfect;
+template<typename T, typename ... L>
+constexpr details::slots<names<T, L...>::count,
+	names<T, L...>::perfect.size> names<T, L...>::hashes;
+template<typename T, typename ... L>
+constexpr details::keyindex<names<T, L...>::count,
+	names<T, L...>::indexed ? names<T, L...>::range : 0> names<T, L...>::index;
 }
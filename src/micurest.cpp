@@ -46,9 +46,306 @@ bool httpmessage::keep() const noexcept {
 	return maykeep && requ.keep && isgood();
 }
 
+/** per-thread cache of rendered response heads, replaced round robin	*/
+template<unsigned N>
+struct headcache {
+	static const headblock* find(uint32_t key) noexcept {
+		for(const headblock& b : blocks)
+			if( b.key == key ) return &b;
+		return nullptr;
+	}
+	static const headblock* store(const headblock& b) noexcept {
+		headblock& dst = blocks[next];
+		next = (next + 1) % N;
+		return &(dst = b);
+	}
+	static thread_local headblock blocks[N];
+	static thread_local unsigned next;
+};
+
+template<unsigned N>
+thread_local headblock headcache<N>::blocks[N];
+template<unsigned N>
+thread_local unsigned headcache<N>::next;
+
+/* no cache, heads are written field by field and write_block is unused */
+template<>
+struct headcache<0> {
+	static const headblock* find(uint32_t) noexcept { return nullptr; }
+	static const headblock* store(const headblock& b) noexcept { return &b; }
+};
+
+/** appends characters to a head block, never past its capacity		*/
+struct headwriter {
+	char_t* const text;
+	size_t size;
+	inline void put(char_t chr) noexcept {
+		if( size < headblock::capacity ) text[size++] = chr;
+	}
+	template<typename S>
+	inline void puts(S str) noexcept {
+		while( *str ) put(*str++);
+	}
+	inline void crlf() noexcept {
+		put(literal<cstring>::CR);
+		put(literal<cstring>::LF);
+	}
+};
+
+/** media type in the Content-Type field, unknown if there is no field	*/
+static inline media::type headmedia(const response& resp) noexcept {
+	return resp.status != status_t::No_Content &&
+		(resp.fields & header::content_type) ?
+			resp.content_type : media::type(media::unknown);
+}
+
+uint32_t httpmessage::headkey() const noexcept {
+	return 1UL << 31 |
+		static_cast<uint32_t>(+resp.status) << 16 |
+		static_cast<uint32_t>(headmedia(resp)) << 8 |
+		static_cast<uint32_t>(requ.version) << 1 |
+		(keep() ? 1 : 0);
+}
+
+void httpmessage::render(headblock& block, uint32_t key) const noexcept {
+	headwriter out { block.text, 0 };
+	out.puts(lit::HTTP::HTTP_());
+	out.put(lit::TSEP);
+	switch( requ.version ) {
+	case http::version::_0_1: out.puts(lit::HTTP::_0_1()); break;
+	case http::version::_1_0: out.puts(lit::HTTP::_1_0()); break;
+	case http::version::UNKNOWN:
+	case http::version::_1_1: out.puts(lit::HTTP::_1_1()); break;
+	}
+	out.put(lit::SPACE);
+	/* HTTP status codes are always three digits 						*/
+	const unsigned code = map::status[+resp.status];
+	out.put('0' + code / 100);
+	out.put('0' + code / 10 % 10);
+	out.put('0' + code % 10);
+	out.put(lit::SPACE);
+	out.puts(micurest::details::literal<>::message(resp.status));
+	out.crlf();
+	const media::type type = headmedia(resp);
+	if( type != media::unknown ) {
+		out.puts(lit::Content_Type());
+		out.put(lit::COLON);
+		out.put(lit::SPACE);
+		out.puts(lit::content_type(type));
+		out.put(lit::TSEP);
+		out.puts(lit::content_subtype(type));
+		out.crlf();
+	}
+	block.split = out.size;
+	out.puts(lit::Connection());
+	out.put(lit::COLON);
+	out.put(lit::SPACE);
+	out.puts(keep() ? lit::keep() : lit::close());
+	out.crlf();
+	block.size = out.size;
+	block.key  = key;
+}
+
+void httpmessage::write_block() noexcept {
+	if( state >= state_t::status ) return;
+	state = state_t::fields;
+	typedef headcache<config::head_cache_size> cache;
+	const uint32_t key = headkey();
+	const headblock* block = cache::find(key);
+	headblock rendered;
+	if( block == nullptr ) {
+		render(rendered, key);
+		block = cache::store(rendered);
+	}
+	output.putn(block->text, block->split);
+	if( resp.status != status_t::No_Content &&
+			(resp.fields & header::content_length) )
+		write_content_length();
+	output.putn(block->text + block->split, block->size - block->split);
+	if( resp.fields & header::etag ) {
+		write_field(lit::ETag());
+		put(etag);
+		crlf();
+	}
+}
+
+/*
+ * Request heads received whole in a contiguous buffer are located with
+ * a word-at-a-time scan for LF and COLON, the method, version and known
+ * header fields are identified by length and word compare.
+ * Only values of known fields are read by the character state machine,
+ * other fields are skipped without being read
+ */
+static constexpr bool scannable =
+	config::scan_head_size != 0 && sizeof(char_t) == 1;
+
+/** loads n <= 8 octets as a word, zero-padded							*/
+static inline uint64_t word(const void* s, size_t n) noexcept {
+	uint64_t w = 0;
+	memcpy(&w, s, n);
+	return w;
+}
+
+/** compares n <= 16 octets of s with literal lit 						*/
+static inline bool same(const void* s, const char* lit, size_t n) noexcept {
+	const char* c = static_cast<const char*>(s);
+	return n <= 8 ? word(c, n) == word(lit, n) :
+		word(c, 8) == word(lit, 8) && word(c + 8, n - 8) == word(lit + 8, n - 8);
+}
+
+/** returns pointer to the first chr in [p, e) or e if there is none	*/
+static const char_t* find(const char_t* p, const char_t* e,
+		char_t chr) noexcept {
+	static constexpr uint64_t lsb = 0x0101010101010101ULL;
+	static constexpr uint64_t msb = 0x8080808080808080ULL;
+	const uint64_t pattern = lsb * static_cast<unsigned char>(chr);
+	for(; e - p >= 8; p += 8) {
+		const uint64_t w = word(p, 8) ^ pattern;
+		if( (w - lsb) & ~w & msb ) break; /* has a zero octet				*/
+	}
+	while( p != e && *p != chr ) ++p;
+	return p;
+}
+
+/** identifies a known header field by its name 						*/
+static header::type known(const char_t* name, size_t len) noexcept {
+	using lic = literal<const char*>;
+	switch( len ) {
+	case 6:
+		return same(name, lic::Accept(), 6) ? header::accept : 0;
+	case 8:
+		return same(name, lic::If_Match(), 8) ? header::if_match : 0;
+	case 10:
+		return same(name, lic::Connection(), 10) ? header::connection : 0;
+	case 12:
+		return same(name, lic::Content_Type(), 12) ? header::content_type : 0;
+	case 13:
+		return same(name, lic::If_None_Match(), 13) ?
+			header::if_none_match : 0;
+	case 14:
+		return same(name, lic::Content_Length(), 14) ?
+			header::content_length : 0;
+	default:
+		return 0;
+	}
+}
+
+bool httpmessage::scan() noexcept {
+	const char_t* const begin = input.head();
+	if( begin == nullptr ) return false;
+	const char_t* const end = begin + input.ahead(config::scan_head_size);
+	const char_t* const eol = find(begin, end, lit::LF);
+	if( eol == end ) return false;
+	/* split heads are left to the state machine 							*/
+	const char_t* lf = eol;
+	for(const char_t* line = eol + 1; ; line = lf + 1) {
+		lf = find(line, end, lit::LF);
+		if( lf == end ) return false;
+		if( lf == line || (lf == line + 1 && *line == lit::CR) ) break;
+	}
+	const char_t* sp = find(begin, eol - begin > 7 ? begin + 7 : eol,
+		lit::SPACE);
+	switch( sp - begin ) {
+	case 3:
+		if( same(begin, lic::GET(), 3) )
+			requ.method = http::method::GET;
+		else if( same(begin, lic::PUT(), 3) )
+			requ.method = http::method::PUT;
+		else
+			return false;
+		break;
+	case 4:
+		if( ! same(begin, lic::POST(), 4) ) return false;
+		requ.method = http::method::POST;
+		break;
+	case 6:
+		if( ! same(begin, lic::DELETE(), 6) ) return false;
+		requ.method = http::method::DELETE;
+		break;
+	default:
+		return false;
+	}
+	head   = begin;
+	tail   = lf + 1;
+	cursor = sp + 1;
+	limit  = eol + 1;
+	return true;
+}
+
+httpmessage::state_t httpmessage::scan_version() noexcept {
+	const char_t* const v = cursor;
+	const size_t n = limit - v;
+	if( (n == 9 || (n == 10 && v[8] == lit::CR)) &&
+			same(v, lic::HTTP::HTTP_(), 4) && v[4] == lit::TSEP ) {
+		if( same(v + 5, lic::HTTP::_1_1(), 3) )
+			requ.version = http::version::_1_1;
+		else if( same(v + 5, lic::HTTP::_1_0(), 3) )
+			requ.version = http::version::_1_0;
+		else if( same(v + 5, lic::HTTP::_0_1(), 3) )
+			requ.version = http::version::_0_1;
+		else
+			return read_version();
+		cursor = limit;
+		return state_t::header;
+	}
+	return read_version();
+}
+
+httpmessage::state_t httpmessage::scan_headers() noexcept {
+	/* the request line has been read up to limit, fields follow it		*/
+	for(const char_t* line = limit; ; line = limit) {
+		const char_t* const lf = find(line, tail, lit::LF);
+		cursor = line;
+		limit = lf + 1;
+		switch( *line ) {
+		case lic::SPACE:
+		case lic::HTAB:
+			return bad_request();
+		case lic::CR:
+			if( lf != line + 1 ) return bad_request();
+			cursor = limit;
+			return state_t::body;
+		case lic::LF:
+			cursor = limit;
+			return state_t::body;
+		}
+		const char_t* const colon = find(line,
+			lf - line > 15 ? line + 15 : lf, lit::COLON);
+		const header::type field = colon != lf ? known(line, colon - line) : 0;
+		if( field == 0 ) continue;
+		cursor = colon + 1;
+		if( read_field(field) || skip_line() ) continue;
+		error(status_t::Bad_Option);
+		return state_t::bad;
+	}
+}
+
+void httpmessage::release() noexcept {
+	input.advance(cursor - head);
+	head = tail = cursor = limit = nullptr;
+}
+
+httpmessage::state_t httpmessage::parse_head() noexcept {
+	switch(state) {
+	case state_t::target:
+	case state_t::version:
+		return scan_version();
+	case state_t::header:
+		return scan_headers();
+	default:
+		return state;
+	}
+}
+
 httpmessage::state_t httpmessage::parse() noexcept {
+	if( scannable && head ) {
+		state = parse_head();
+		if( state < state_t::target || state > state_t::header ) release();
+		return state;
+	}
 	switch(state) {
 	case state_t::method:
+		if( scannable && scan() ) return state = state_t::target;
 		return state = read_method();
 	case state_t::target:
 	case state_t::version:
@@ -293,36 +590,20 @@ httpmessage::state_t httpmessage::read_headers() noexcept {
 		case lic::CR:
 			return expect_crlf() ? state_t::body : bad_request();
 		case lic::Accept()[0]:
-			if( literal1(lit::Accept()+1,{lit::COLON}) ) {
-				if( read_accept() ) {
-					requ.fields |= header::accept;
-					continue;
-				}
-			}
+			if( literal1(lit::Accept()+1,{lit::COLON}) &&
+				read_field(header::accept) ) continue;
 			break;
 		case lic::Content_Length()[0]:
 			switch( literal3(lit::Content_Length()+1, lit::Content_Type()+1,
 					lit::Connection()+1, {lit::COLON})) {
 			case 1:
-				if( read_length() ) {
-					requ.fields |= header::content_length;
-					consume_crlf();
-					continue;
-				}
+				if( read_field(header::content_length) ) continue;
 				break;
 			case 2:
-				if( (requ.content_type = read_mediatype()) ) {
-					requ.fields |= header::content_type;
-					expect_crlf();
-					continue;
-				}
+				if( read_field(header::content_type) ) continue;
 				break;
 			case 3:
-				if( read_connection() ) {
-					requ.fields |= header::connection;
-					expect_crlf();
-					continue;
-				}
+				if( read_field(header::connection) ) continue;
 			}
 			break;
 		case lic::If_Match()[0]:
@@ -341,13 +622,50 @@ httpmessage::state_t httpmessage::read_headers() noexcept {
 
 bool httpmessage::read_condition() noexcept {
 	switch(literals(lit::If_Match()+1,lit::If_None_Match()+1, {lit::COLON})) {
-	case 1: return read_etag() && (requ.fields |= header::if_match);
-	case 2: return read_etag() && (requ.fields |= header::if_none_match);
+	case 1: return read_field(header::if_match);
+	case 2: return read_field(header::if_none_match);
 	default:
 		return error(status_t::Bad_Request);
 	}
 }
 
+/** reads value of a known header field and marks it present			*/
+bool httpmessage::read_field(header::type field) noexcept {
+	switch( field ) {
+	case header::accept:
+		if( ! read_accept() ) return false;
+		break;
+	case header::content_length:
+		if( ! read_length() ) return false;
+		consume_crlf();
+		break;
+	case header::content_type:
+		if( ! (requ.content_type = read_mediatype()) ) return false;
+		expect_crlf();
+		break;
+	case header::connection:
+		if( ! read_connection() ) return false;
+		expect_crlf();
+		break;
+	default: /* if_match, if_none_match									*/
+		if( ! read_etag() ) return false;
+	}
+	requ.fields |= field;
+	return true;
+}
+
+bool httpmessage::read_length() noexcept {
+	if( cursor == nullptr ) {
+		details::lexer in(input);
+		return details::reader<size_t>::read(requ.content_length, in);
+	}
+	buffer line(const_cast<char_t*>(cursor), limit - cursor);
+	details::lexer in(line);
+	const bool res = details::reader<size_t>::read(requ.content_length, in);
+	cursor += line.count();
+	return res;
+}
+
 bool httpmessage::read_etag() noexcept {
 	//FIXME Etag is quoted with ""
 	size_t i = 0;
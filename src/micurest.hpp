@@ -627,6 +627,18 @@ protected:
 	char_t etag[etag_size] = {}; /* etag can be shared to save RAM */
 };
 
+/**
+ * Rendered status line, Content-Type and Connection fields of an HTTP
+ * response. Content-Length, when present, is spliced in at split
+ */
+struct headblock {
+	static constexpr size_t capacity = 128;
+	uint32_t key;	/* version, status, media type and keep, see headkey	*/
+	uint8_t  split;	/* offset of the Connection field						*/
+	uint8_t  size;
+	char_t   text[capacity];
+};
+
 /**
  *
  */
@@ -699,8 +711,7 @@ protected:
 		if( state >= state_t::sealed ) return;
 		if( final && resp.status == status_t::Unknown )
 			resp.status = status_t::OK;
-		write_status();
-		write_headers();
+		write_head();
 		if( final ) {
 			state = state_t::sealed;
 			if( is_nocontent() )
@@ -794,6 +805,20 @@ protected:
 		}
 	}
 
+	/** writes the head from a cached block or, with no cache, field by
+	 *  field, so that MCU targets do not render a block on the stack	*/
+	inline void write_head() noexcept {
+		if( config::head_cache_size ) write_block();
+		else {
+			write_status();
+			write_headers();
+		}
+	}
+
+	uint32_t headkey() const noexcept;
+	void render(headblock&, uint32_t key) const noexcept;
+	void write_block() noexcept;
+
 	inline void write_field(cstring field) const noexcept {
 		put(field);
 		put(lit::COLON);
@@ -831,7 +856,13 @@ private:
 	state_t read_version() noexcept;
 	inline state_t read_headers() noexcept;
 	inline bool read_condition() noexcept;
+	bool read_field(header::type) noexcept;
 	bool read_connection() noexcept;
+	bool scan() noexcept;
+	state_t scan_version() noexcept;
+	state_t scan_headers() noexcept;
+	state_t parse_head() noexcept;
+	void release() noexcept;
 	bool literal1(cstring, const delimiters& = {lit::LF}) noexcept;
 	bool literal1_ic(cstring, const delimiters& = {lit::LF}) noexcept;
 	unsigned char literals(cstring, cstring,
@@ -844,16 +875,19 @@ private:
 	inline media::type read_mediatypetext() noexcept;
 	inline media::type read_mediatypeapp() noexcept;
 	inline media::type read_mediatypeappj() noexcept;
-	bool read_length() noexcept {
-		details::lexer in(input);
-		return details::reader<size_t>::read(requ.content_length, in);
-	}
+	bool read_length() noexcept;
 
 	bool expect_crlf() noexcept;
 	bool consume_crlf() noexcept;
 
 	inline bool get() noexcept {
-		return input.get(curr);
+		if( cursor == nullptr ) return input.get(curr);
+		if( cursor == limit ) {
+			curr = iostate::eos_c;
+			return false;
+		}
+		curr = *cursor++;
+		return true;
 	}
 	inline bool put(char_t v) const noexcept {
 		return output.put(v);
@@ -891,6 +925,11 @@ protected:
 	state_t state = state_t::method;
 	const node* target;
 	bool maykeep  = false;
+	/* request head located in a contiguous input by scan()				*/
+	const char_t* head   = nullptr;	/* start of the request line		*/
+	const char_t* tail   = nullptr;	/* past the empty line ending it	*/
+	const char_t* cursor = nullptr;	/* next character to read			*/
+	const char_t* limit  = nullptr;	/* end of the line being read		*/
 };
 
 /** Finds an CER entry with unknown status */
@@ -915,7 +954,7 @@ template<typename T>
 static inline bool convert(const char_t* str, T& dst) noexcept {
 	T val = {};
 	while(*str) {
-		if( +(cojson::details::chartype(*str) & cojson::details::ctype::digit) ) {
+		if( +(cojson::details::ctypeof(*str) & cojson::details::ctype::digit) ) {
 			if( ! tenfold<decltype(val)>(val,*str-'0') ) return false;
 //			if( val > 0xFF ) return false;
 		} else {
@@ -66,6 +66,9 @@ char32-DEFS       := TEST_CHAR32_T
 overflow-DEFS     := TEST_OVERFLOW_ERROR
 saturate-DEFS     := TEST_OVERFLOW_SATURATE
 sprintf-DEFS      := TEST_WITH_SPRINTF
+memo-DEFS         := TEST_NUMBER_MEMO
+numlex-DEFS       := TEST_NUMBER_TABLE
+absent-DEFS       := TEST_ABSENT_OMITTED
 
 wchar-INCLUDES    := $(BASE-DIR)/suites/wchar
 char16-INCLUDES   := $(BASE-DIR)/suites/wchar
@@ -73,14 +76,21 @@ char32-INCLUDES   := $(BASE-DIR)/suites/wchar
 overflow-INCLUDES := $(BASE-DIR)/suites/basic
 saturate-INCLUDES := $(BASE-DIR)/suites/basic
 sprintf-INCLUDES  := $(BASE-DIR)/suites/basic
+memo-INCLUDES     := $(BASE-DIR)/suites/basic
+numlex-INCLUDES   := $(BASE-DIR)/suites/basic
+absent-INCLUDES   := $(BASE-DIR)/suites/basic
 
 uchar-OBJS        := $(host-OBJS)
 sprintf-OBJS      := $(host-OBJS)
+memo-OBJS         := $(host-OBJS)
+numlex-OBJS       := $(host-OBJS)
+absent-OBJS       := $(host-OBJS)
 wchar-OBJS        := 070.o
 char16-OBJS	      := 071.o
 char32-OBJS	      := 072.o
 overflow-OBJS     := 034.o
 saturate-OBJS     := 034.o
+cpp17-OBJS        := 111.o
 
 OBJS := 																	\
   $(COJSON-OBJS)															\
@@ -140,6 +150,7 @@ $(TARGET-DIR):
 	@mkdir -p $(TARGET-DIR)
 
 uchar: CPPFLAGS += -funsigned-char
+cpp17: CPPFLAGS += -std=c++17
 
 $(TARGET): $(TARGET-DIR)/$(TARGET)
 
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 037.cpp - cojson tests, reading zero-copy strings
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+NAME(a)
+NAME(b)
+NAME(c)
+
+static char_t scratch[16];
+static string_view sv;
+
+struct Pod37 {
+	string_view a;
+	string_view b;
+	int c;
+};
+
+static const clas<Pod37>& pod() noexcept {
+	return O<Pod37,
+		P<Pod37, a, string_view, &Pod37::a>,
+		P<Pod37, b, string_view, &Pod37::b>,
+		P<Pod37, c, int, &Pod37::c>
+	>();
+}
+
+static inline bool same(const string_view& v, const char_t* answer) noexcept {
+	return v.size() == strlen(answer) &&
+		strncmp(v.data(), answer, v.size()) == 0;
+}
+
+static inline bool inplace(const string_view& v, const char_t* inp) noexcept {
+	return v.data() >= inp && v.data() < inp + strlen(inp);
+}
+
+/** reads a string_view from a contiguous buffer, in place or unescaped */
+static result_t runv(const Environment& env, const char_t* inp,
+		const char_t* answer, bool copy,
+		error_t expected = error_t::noerror) noexcept {
+	buffer src(inp);
+	arena mem(scratch);
+	lexer in(src, &mem);
+	bool r = V<string_view, &sv>().read(in);
+	bool m = same(sv, answer) && (copy ? ! inplace(sv, inp) : inplace(sv, inp));
+	env.out(r && m, "%.*s\n", (int)sv.size(), sv.data());
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+/** reads a string_view from a non-contiguous stream */
+static result_t runs(const Environment& env, cstring inp,
+		const char_t* answer, error_t expected = error_t::noerror) noexcept {
+	static cstream src;
+	src.set(inp);
+	arena mem(scratch);
+	lexer in(src, &mem);
+	bool r = V<string_view, &sv>().read(in);
+	bool m = same(sv, answer);
+	env.out(r && m, "%.*s\n", (int)sv.size(), sv.data());
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+struct Test037 : Test {
+	static Test037 tests[];
+	inline Test037(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test037(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test037 Test037::tests[] = {
+	RUN("string_view: plain string in place", {
+		return runv(env, "\"qwerty\"", "qwerty", false);					}),
+	RUN("string_view: longer than scratch in place", {
+		return runv(env, "\"0123456789012345678901234567891\"",
+				"0123456789012345678901234567891", false);					}),
+	RUN("string_view: escaped string unescaped to scratch", {
+		return runv(env, "\"quotes: \\\"\\n\"", "quotes: \"\n", true);	}),
+	RUN("string_view: escaped string overruns scratch", {
+		return runv(env, "\"0123456789\\t0123456789\"", "", true,
+				error_t::overrun);											}),
+	RUN("string_view: null", {
+		return runv(env, "null", "", true);									}),
+	RUN("string_view: mismatching number", {
+		return runv(env, "123", "", true, error_t::mismatch);				}),
+	RUN("string_view: decoded from a stream", {
+		return runs(env, CSTR("\"str\\u0040eam\""), "str@eam");			}),
+	RUN("string_view: stream overruns scratch", {
+		return runs(env, CSTR("\"0123456789ABCDEF\""), "",
+				error_t::overrun);											}),
+	RUN("string_view: POD properties", {
+		static const char_t inp[] =
+				"{\"a\":\"in place\",\"b\":\"esc\\\\aped\",\"c\":37}";
+		buffer src(inp);
+		arena mem(scratch);
+		lexer in(src, &mem);
+		Pod37 obj {};
+		bool r = pod().read(obj, in);
+		bool m = same(obj.a, "in place") && inplace(obj.a, inp) &&
+				 same(obj.b, "esc\\aped") && ! inplace(obj.b, inp) &&
+				 obj.c == 37;
+		env.out(r && m, "%.*s %.*s %d\n", (int)obj.a.size(), obj.a.data(),
+				(int)obj.b.size(), obj.b.data(), obj.c);
+		return combine2(r, m, in.error());									}),
+};
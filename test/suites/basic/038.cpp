@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 038.cpp - cojson tests, reading/writing dictionaries
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+NAME(a)
+NAME(b)
+
+typedef dictionary<int, 4, 8> Dict38;
+static Dict38 dict;
+typedef dictionary<bool, 2, 4> Flags38;
+
+struct Pod38 {
+	int a;
+	Dict38 b;
+};
+
+static const clas<Pod38>& pod() noexcept {
+	return O<Pod38,
+		P<Pod38, a, int, &Pod38::a>,
+		P<Pod38, b, Dict38, &Pod38::b>
+	>();
+}
+
+static result_t rund(const Environment& env, const char_t* inp,
+		const char_t* answer, error_t expected = error_t::noerror) noexcept {
+	static char_t out[128];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	bool r = V<Dict38, &dict>().read(in);
+	r = V<Dict38, &dict>().write(dst) && dst.put(0) && r;
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+struct Test038 : Test {
+	static Test038 tests[];
+	inline Test038(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test038(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test038 Test038::tests[] = {
+	RUN("dictionary: insertion order", {
+		return rund(env, "{\"z\":1, \"y\":2, \"x\":3}",
+				"{\"z\":1,\"y\":2,\"x\":3}");								}),
+	RUN("dictionary: empty object", {
+		return rund(env, "{}", "{}");										}),
+	RUN("dictionary: null clears", {
+		return rund(env, "null", "{}");										}),
+	RUN("dictionary: duplicate key updates the value", {
+		return rund(env, "{\"k\":1,\"j\":2,\"k\":3}", "{\"k\":3,\"j\":2}");	}),
+	RUN("dictionary: escaped key", {
+		return rund(env, "{\"\\u0041b\":1}", "{\"Ab\":1}");					}),
+	RUN("dictionary: too many keys", {
+		return rund(env, "{\"a\":1,\"b\":2,\"c\":3,\"d\":4,\"e\":5,\"a\":6}",
+				"{\"a\":6,\"b\":2,\"c\":3,\"d\":4}", error_t::overrun);		}),
+	RUN("dictionary: too long key", {
+		return rund(env, "{\"abcdefgh\":1,\"b\":2}", "{\"b\":2}",
+				error_t::overrun);											}),
+	RUN("dictionary: value not read is reset", {
+		static char_t out[32];
+		static Flags38 flags;
+		buffer src1("{\"f\":true}");
+		buffer src2("{\"f\":1}");
+		buffer dst(out);
+		lexer in1(src1);
+		lexer in2(src2);
+		bool r = flags.read(in1);
+		bool m = ! flags.read(in2) && flags.count() == 1;
+		r = flags.write(dst) && dst.put(0) && r;
+		m = m && strcmp(out, "{\"f\":false}") == 0;
+		env.out(r && m, "%s\n", out);
+		return combine2(r, m, in1.error());									}),
+	RUN("dictionary: find and insert", {
+		static const char_t inp[] = "{\"a\":1,\"b\":{\"x\":10,\"yy\":20}}";
+		buffer src(inp);
+		lexer in(src);
+		Pod38 obj {};
+		bool r = pod().read(obj, in);
+		const int* x = obj.b.find("x");
+		const int* yy = obj.b.find("yy");
+		int* zz = obj.b.insert("zz");
+		if( zz ) *zz = 30;
+		bool m = obj.a == 1 && obj.b.count() == 3 && x && *x == 10 &&
+				 yy && *yy == 20 && zz && obj.b.find("y") == nullptr &&
+				 obj.b.insert("yy") == yy;
+		env.out(r && m, "%d %d %d\n", obj.b.count(), x ? *x : 0, yy ? *yy : 0);
+		return combine2(r, m, in.error());									}),
+};
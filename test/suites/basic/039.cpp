@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 039.cpp - cojson tests, reading/writing NDJSON records
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+NAME(a)
+NAME(b)
+
+struct Rec39 {
+	int a;
+	bool b;
+};
+
+static const clas<Rec39>& rec() noexcept {
+	return O<Rec39,
+		P<Rec39, a, int, &Rec39::a>,
+		P<Rec39, b, bool, &Rec39::b>
+	>();
+}
+
+static int sum;
+static int errors;
+static int flushes;
+
+static bool handler(Rec39& r, error_t e) noexcept {
+	if( e != error_t::noerror ) ++errors;
+	else sum += r.a;
+	r = Rec39 {};
+	return true;
+}
+
+static bool flusher(ostream&) noexcept {
+	++flushes;
+	return true;
+}
+
+static result_t runr(const Environment& env, const char_t* inp,
+		unsigned records, int answer, int errs) noexcept {
+	buffer src(inp);
+	lexer in(src);
+	Rec39 r {};
+	sum = errors = 0;
+	unsigned n = ReadRecords(rec(), r, in, handler);
+	bool m = n == records && sum == answer && errors == errs;
+	env.out(m, "%d %d %d\n", n, sum, errors);
+	return combine2(true, m, error_t::noerror);
+}
+
+struct Test039 : Test {
+	static Test039 tests[];
+	inline Test039(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test039(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test039 Test039::tests[] = {
+	RUN("NDJSON: reading records", {
+		return runr(env, "{\"a\":1,\"b\":true}\n{\"a\":2}\n{\"a\":3}\n",
+				3, 6, 0);													}),
+	RUN("NDJSON: no trailing newline, blank lines", {
+		return runr(env, "\n{\"a\":1}\r\n\n  {\"a\":2}", 2, 3, 0);			}),
+	RUN("NDJSON: malformed record skipped to the end of line", {
+		return runr(env, "{\"a\":1}\n{\"a\":x, \"b\":true}\n{\"a\":4}\n",
+				3, 5, 1);													}),
+	RUN("NDJSON: mismatching record does not stop the stream", {
+		return runr(env, "{\"a\":\"s\"}\n{\"a\":4}\n", 2, 4, 1);			}),
+	RUN("NDJSON: truncated record does not take the next one", {
+		return runr(env, "{\"a\":1\n{\"a\":2}\n{\"a\":3,\n{\"a\":4}\n",
+				4, 6, 2);													}),
+	RUN("NDJSON: truncated literal does not take the next one", {
+		return runr(env, "{\"a\":1,\"b\":tr\n{\"a\":2}", 2, 2, 1);		}),
+	RUN("NDJSON: record of another type is skipped", {
+		return runr(env, "[1]\n{\"a\":4}\n\"x\"\n", 3, 4, 2);			}),
+	RUN("NDJSON: multi-line document keeps no character back on error", {
+		buffer src("{\n\"a\":1\n{}");
+		lexer in(src);
+		Rec39 r {};
+		bool res = ! rec().read(r, in);
+		bool m = in.head() != nullptr;
+		env.out(res && m, "%d\n", r.a);
+		return combine2(res, m, Test::expected(in.error(), error_t::bad));	}),
+	RUN("NDJSON: empty stream", {
+		return runr(env, " \n", 0, 0, 0);									}),
+	RUN("NDJSON: writing records with flush policy", {
+		static char_t out[128];
+		buffer dst(out);
+		recordwriter w(dst, flusher, 2);
+		Rec39 r {};
+		r.a = 1;
+		r.b = true;
+		flushes = 0;
+		bool res = w.write(rec(), r);
+		r.a = 2;
+		res = res && w.write(rec(), r);
+		r.a = 3;
+		res = res && w.write(rec(), r) && dst.put(0);
+		bool m = flushes == 1 && strcmp(out,
+			"{\"a\":1,\"b\":true}\n{\"a\":2,\"b\":true}\n"
+			"{\"a\":3,\"b\":true}\n") == 0;
+		env.out(res && m, "%s %d\n", out, flushes);
+		return combine2(res, m, dst.error());								}),
+	RUN("NDJSON: flush by bytes", {
+		static char_t out[128];
+		buffer dst(out);
+		recordwriter w(dst, flusher, 0, 20);
+		Rec39 r {};
+		r.a = 12;
+		flushes = 0;
+		bool res = w.write(rec(), r) && w.write(rec(), r) &&
+				   w.write(rec(), r);
+		bool m = flushes == 1;
+		env.out(res && m, "%d\n", flushes);
+		return combine2(res, m, dst.error());								}),
+};
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 040.cpp - cojson tests, presence of members
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+NAME(a)
+NAME(b)
+NAME(c)
+
+struct Pod40 {
+	int a;
+	bool b;
+	int c;
+};
+
+static const clas<Pod40>& pod() noexcept {
+	return O<Pod40,
+		P<Pod40, a, int, &Pod40::a>,
+		P<Pod40, b, bool, &Pod40::b>,
+		P<Pod40, c, int, &Pod40::c>
+	>();
+}
+
+/* members with no value are written as null unless the absent goal
+ * configures them omitted */
+static constexpr bool omitted = config::absent_omitted;
+
+static int va = 1;
+static int vb = 2;
+static bool hasa;
+static bool hasb;
+static int* pa() noexcept { return hasa ? &va : nullptr; }
+static int* pb() noexcept { return hasb ? &vb : nullptr; }
+
+static result_t runp(const Environment& env, const char_t* inp,
+		const char_t* answer, const char* marks,
+		error_t expected = error_t::noerror) noexcept {
+	static char_t out[64];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	Pod40 obj {};
+	bitmap<3> set;
+	bool r = pod().read(obj, in, set);
+	r = pod().write(obj, dst, set) && dst.put(0) && r;
+	bool m = strcmp(out, answer) == 0;
+	for(unsigned i = 0; i < 3; ++i)
+		m = m && set.test(i) == (marks[i] == '1');
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+static result_t runo(const Environment& env, const char_t* answer) noexcept {
+	static char_t out[64];
+	buffer dst(out);
+	bool r = V<
+		M<a, int, pa>,
+		M<b, int, pb>
+	>().write(dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, dst.error());
+}
+
+struct Test040 : Test {
+	static Test040 tests[];
+	inline Test040(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test040(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test040 Test040::tests[] = {
+	RUN("presence: members read are marked", {
+		return runp(env, "{\"c\":3,\"b\":true}", "{\"b\":true,\"c\":3}",
+				"011");														}),
+	RUN("presence: no members", {
+		return runp(env, "{}", "{}", "000");								}),
+	RUN("presence: unknown member is not marked", {
+		return runp(env, "{\"x\":\"a\",\"c\":1}", "{\"c\":1}", "001");	}),
+	RUN("presence: filled map writes all members", {
+		static char_t out[64];
+		buffer dst(out);
+		Pod40 obj {};
+		obj.a = 7;
+		bitmap<3> set;
+		set.fill();
+		set.reset(1);
+		bool r = pod().write(obj, dst, set) && dst.put(0);
+		bool m = strcmp(out, "{\"a\":7,\"c\":0}") == 0 && ! set.test(3);
+		env.out(r && m, "%s\n", out);
+		return combine2(r, m, dst.error());									}),
+	RUN("presence: member with no value", {
+		hasa = false;
+		hasb = true;
+		return runo(env, omitted ? "{\"b\":2}" : "{\"a\":null,\"b\":2}");	}),
+	RUN("presence: all members with no value", {
+		hasa = hasb = false;
+		return runo(env, omitted ? "{}" : "{\"a\":null,\"b\":null}");		}),
+	RUN("presence: all members with values", {
+		hasa = hasb = true;
+		return runo(env, "{\"a\":1,\"b\":2}");								}),
+};
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 041.cpp - cojson tests, reading trusted input
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+NAME(a)
+NAME(b)
+NAME(c)
+NAME(s)
+
+struct Pod41 {
+	short a;
+	bool b;
+	long c;
+	char_t s[8];
+};
+
+static const clas<Pod41>& pod() noexcept {
+	return O<Pod41,
+		P<Pod41, a, short, &Pod41::a>,
+		P<Pod41, b, bool, &Pod41::b>,
+		P<Pod41, c, long, &Pod41::c>,
+		P<Pod41, s, countof(&Pod41::s), &Pod41::s>
+	>();
+}
+
+static result_t runt(const Environment& env, const char_t* inp,
+		const char_t* answer) noexcept {
+	static char_t out[64];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src, nullptr, lexer::input::trusted);
+	Pod41 obj {};
+	bool r = pod().read(obj, in);
+	r = pod().write(obj, dst) && dst.put(0) && r;
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, in.error());
+}
+
+static result_t runv(const Environment& env, const char_t* inp,
+		long answer) noexcept {
+	buffer src(inp);
+	long val = 0;
+	bool r = Read(val, src, lexer::input::trusted);
+	bool m = val == answer;
+	env.out(r && m, "%ld\n", val);
+	return combine2(r, m, src.error() & ~error_t::eof);
+}
+
+static result_t runm(const Environment& env, const char_t* inp) noexcept {
+	buffer src(inp);
+	lexer in(src, nullptr, lexer::input::trusted);
+	bool val = false;
+	in.assume(lexer::input::checked);
+	bool r = ! Read(val, in) && in.error() != error_t::noerror;
+	env.out(r, "%d\n", val);
+	return combine2(r, true, error_t::noerror);
+}
+
+struct Test041 : Test {
+	static Test041 tests[];
+	inline Test041(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test041(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test041 Test041::tests[] = {
+	RUN("trusted input: object", {
+		return runt(env,
+			"{\"a\":-32768,\"b\":true,\"c\":2147483647,\"s\":\"x\\\"y\"}",
+			"{\"a\":-32768,\"b\":true,\"c\":2147483647,\"s\":\"x\\\"y\"}");	}),
+	RUN("trusted input: whitespace and unknown members", {
+		return runt(env,
+			"{ \"x\" : [false, {\"y\":null}] , \"b\" : false ,"
+			" \"a\" : 12 }",
+			"{\"a\":12,\"b\":false,\"c\":0,\"s\":\"\"}");					}),
+	RUN("trusted input: value at the end of stream", {
+		return runv(env, "-12345", -12345);									}),
+	RUN("trusted input: mode is per read", {
+		return runm(env, "tru ");											}),
+};
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 042.cpp - cojson tests, writing constant values
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+static constexpr auto caps = json::object(
+	json::member("name", "dev\t\"1\""),
+	json::member("ports", json::array(-32768, 0, 65535)),
+	json::member("on", true),
+	json::member("none", nullptr),
+	json::member("modes", json::array("in", "out")),
+	json::member("nested", json::object(json::member("x", false))));
+
+static constexpr auto empty = json::array();
+
+static constexpr auto control = json::array("\x01");
+
+NAME(c)
+NAME(n)
+
+static int num = 1;
+
+template<typename T, const T& J>
+static result_t runc(const Environment& env, const char_t* answer) noexcept {
+	static char_t out[160];
+	buffer dst(out);
+	bool r = V<T, J>().write(dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0 &&
+		details::constant<T, J>::length == strlen(answer);
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, dst.error());
+}
+
+static result_t runcaps(const Environment& env, const char_t* answer) noexcept {
+	return runc<decltype(caps), caps>(env, answer);
+}
+
+static result_t runempty(const Environment& env, const char_t* answer) noexcept {
+	return runc<decltype(empty), empty>(env, answer);
+}
+
+static result_t runcontrol(const Environment& env,
+		const char_t* answer) noexcept {
+	return runc<decltype(control), control>(env, answer);
+}
+
+static result_t runmember(const Environment& env,
+		const char_t* answer) noexcept {
+	static char_t out[64];
+	buffer dst(out);
+	bool r = V<
+		M<c, V<decltype(empty), empty>>,
+		M<n, int, &num>
+	>().write(dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, dst.error());
+}
+
+static result_t runoverrun(const Environment& env) noexcept {
+	static char_t out[8];
+	buffer dst(out);
+	bool r = ! V<decltype(caps), caps>().write(dst);
+	env.out(r, "%.8s\n", out);
+	return combine2(r, true, dst.error() & ~error_t::eof);
+}
+
+struct Test042 : Test {
+	static Test042 tests[];
+	inline Test042(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test042(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test042 Test042::tests[] = {
+	RUN("constant: composed object", {
+		return runcaps(env,
+			"{\"name\":\"dev\\t\\\"1\\\"\",\"ports\":[-32768,0,65535],"
+			"\"on\":true,\"none\":null,\"modes\":[\"in\",\"out\"],"
+			"\"nested\":{\"x\":false}}");									}),
+	RUN("constant: empty array", {
+		return runempty(env, "[]");											}),
+	RUN("constant: control character", {
+		return runcontrol(env, "[\"\\u0001\"]");							}),
+	RUN("constant: member of an object", {
+		return runmember(env, "{\"c\":[],\"n\":1}");						}),
+	RUN("constant: buffer overrun", {
+		return runoverrun(env);												}),
+};
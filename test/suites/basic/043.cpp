@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 043.cpp - cojson tests, streaming consumption of arrays
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+
+NAME(a)
+NAME(b)
+
+struct Pod43 {
+	int a;
+	bool b;
+};
+
+static const clas<Pod43>& pod() noexcept {
+	return O<Pod43,
+		P<Pod43, a, int, &Pod43::a>,
+		P<Pod43, b, bool, &Pod43::b>
+	>();
+}
+
+/* consumer log: sum of values weighted by index + 1, number of calls */
+static long sum;
+static unsigned calls;
+static unsigned limit;
+
+static bool ints(const int& v, unsigned i) noexcept {
+	if( calls == limit ) return false;
+	sum += v * (i + 1);
+	++calls;
+	return true;
+}
+
+static bool pods(const Pod43& v, unsigned i) noexcept {
+	sum += (v.a + (v.b ? 100 : 0)) * (i + 1);
+	++calls;
+	return true;
+}
+
+static result_t runs(const Environment& env, const char_t* inp,
+		const details::value& val, long answer, unsigned count,
+		unsigned lim = 100, error_t expected = error_t::noerror) noexcept {
+	buffer src(inp);
+	lexer in(src);
+	sum = 0;
+	calls = 0;
+	limit = lim;
+	bool r = val.read(in);
+	bool m = sum == answer && calls == count;
+	env.out(r && m, "%ld %u\n", sum, calls);
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+static result_t runints(const Environment& env, const char_t* inp,
+		long answer, unsigned count, unsigned lim = 100,
+		error_t expected = error_t::noerror) noexcept {
+	return runs(env, inp, V<int, ints>(), answer, count, lim, expected);
+}
+
+static result_t runpods(const Environment& env, const char_t* inp,
+		long answer, unsigned count) noexcept {
+	return runs(env, inp, V<Pod43, pod, pods>(), answer, count);
+}
+
+struct Test043 : Test {
+	static Test043 tests[];
+	inline Test043(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test043(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test043 Test043::tests[] = {
+	RUN("stream: scalars", {
+		return runints(env, "[1, 2, 3, 4]", 30, 4);							}),
+	RUN("stream: objects, buffer is reset between elements", {
+		return runpods(env, "[{\"a\":1,\"b\":true},{\"a\":2}]", 105, 2);	}),
+	RUN("stream: null and empty array", {
+		return combinu(runints(env, "null", 0, 0) |
+			runints(env, "[]", 0, 0));								}),
+	RUN("stream: element mismatch is skipped", {
+		return runints(env, "[1,true,3]", 10, 2, 100, error_t::mismatch);	}),
+	RUN("stream: consumer aborts", {
+		return runints(env, "[1,2,3,4]", 5, 2, 2, error_t::overrun);		}),
+};
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 044.cpp - cojson tests, writing generated arrays
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+NAME(a)
+NAME(b)
+NAME(s)
+
+struct Pod44 {
+	int a;
+	bool b;
+};
+
+static const clas<Pod44>& pod() noexcept {
+	return O<Pod44,
+		P<Pod44, a, int, &Pod44::a>,
+		P<Pod44, b, bool, &Pod44::b>
+	>();
+}
+
+/* ring buffer of samples, oldest at head */
+static short ring[4] = { 30, 40, 10, 20 };
+static unsigned head = 2;
+static unsigned count = 4;
+
+static bool samples(short& v, unsigned i) noexcept {
+	if( i >= count ) return false;
+	v = ring[(head + i) & 3];
+	return true;
+}
+
+static bool pods(Pod44& v, unsigned i) noexcept {
+	v.a = i * 10;
+	v.b = i & 1;
+	return i < 2;
+}
+
+static const short* first() noexcept { return ring + 1; }
+static const short* last() noexcept { return ring + 3; }
+
+struct Window44 {
+	const short* b;
+	const short* e;
+	const short* begin() const noexcept { return b; }
+	const short* end() const noexcept { return e; }
+};
+
+static Window44 window() noexcept { return Window44 { ring, ring + 2 }; }
+
+typedef accessor::generator<short, samples> G44;
+typedef accessor::generator<Pod44, pods> O44;
+typedef accessor::iterators<const short*, first, last> I44;
+typedef accessor::range<Window44, window> R44;
+
+static result_t rung(const Environment& env, const details::value& val,
+		const char_t* answer) noexcept {
+	static char_t out[64];
+	buffer dst(out);
+	bool r = val.write(dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, dst.error());
+}
+
+static result_t runempty(const Environment& env) noexcept {
+	count = 0;
+	result_t r = rung(env, V<G44>(), "[]");
+	count = 4;
+	return r;
+}
+
+static result_t runobjects(const Environment& env) noexcept {
+	return rung(env, V<O44, pod>(),
+		"[{\"a\":0,\"b\":false},{\"a\":10,\"b\":true}]");
+}
+
+static result_t runmember(const Environment& env) noexcept {
+	return rung(env, V<M<s, I44>>(), "{\"s\":[40,10]}");
+}
+
+struct Test044 : Test {
+	static Test044 tests[];
+	inline Test044(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test044(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test044 Test044::tests[] = {
+	RUN("generator: ring buffer via callback", {
+		return rung(env, V<G44>(), "[10,20,30,40]");						}),
+	RUN("generator: empty", {
+		return runempty(env);												}),
+	RUN("generator: iterator pair", {
+		return rung(env, V<I44>(), "[40,10]");								}),
+	RUN("generator: range", {
+		return rung(env, V<R44>(), "[30,40]");								}),
+	RUN("generator: objects", {
+		return runobjects(env);												}),
+	RUN("generator: member of an object", {
+		return runmember(env);												}),
+};
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 045.cpp - cojson tests, binary data in base64
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+NAME(fw)
+NAME(n)
+
+struct Pod45 {
+	binary<6> fw;
+	int n;
+};
+
+static const clas<Pod45>& pod() noexcept {
+	return O<Pod45,
+		P<Pod45, fw, binary<6>, &Pod45::fw>,
+		P<Pod45, n, int, &Pod45::n>
+	>();
+}
+
+static unsigned chunks;
+static unsigned total;
+static bool intact;
+
+static bool consume(const unsigned char* data, unsigned size) noexcept {
+	for(unsigned i = 0; i < size; ++i)
+		intact = intact && data[i] == total + i;
+	++chunks;
+	total += size;
+	return true;
+}
+
+static result_t runb(const Environment& env, const char_t* inp,
+		const char_t* answer, unsigned size,
+		error_t expected = error_t::noerror) noexcept {
+	static char_t out[64];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	Pod45 obj {};
+	bool r = pod().read(obj, in) || expected == error_t::bad;
+	r = pod().write(obj, dst) && dst.put(0) && r;
+	bool m = strcmp(out, answer) == 0 && obj.fw.size == size;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+static result_t runs(const Environment& env, const char_t* inp,
+		unsigned size) noexcept {
+	buffer src(inp);
+	lexer in(src);
+	chunks = total = 0;
+	intact = true;
+	bool r = V<consume>().read(in);
+	bool m = total == size && chunks == (size + 47) / 48 && intact;
+	env.out(r && m, "%u octets in %u chunks\n", total, chunks);
+	return combine2(r, m, in.error());
+}
+
+struct Test045 : Test {
+	static Test045 tests[];
+	inline Test045(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test045(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test045 Test045::tests[] = {
+	RUN("binary: padded", {
+		return runb(env, "{\"fw\":\"AQID/w==\",\"n\":1}",
+			"{\"fw\":\"AQID/w==\",\"n\":1}", 4);							}),
+	RUN("binary: unpadded tail", {
+		return runb(env, "{\"fw\":\"AQI\"}", "{\"fw\":\"AQI=\",\"n\":0}", 2);	}),
+	RUN("binary: null and empty", {
+		return combinu(runb(env, "{\"fw\":null}", "{\"fw\":\"\",\"n\":0}", 0) |
+			runb(env, "{\"fw\":\"\"}", "{\"fw\":\"\",\"n\":0}", 0));		}),
+	RUN("binary: overrun", {
+		return runb(env, "{\"fw\":\"AAECAwQFBgc=\",\"n\":2}",
+			"{\"fw\":\"AAECAwQF\",\"n\":2}", 6, error_t::overrun);			}),
+	RUN("binary: invalid character", {
+		return runb(env, "{\"n\":3,\"fw\":\"AQ*D\"}",
+			"{\"fw\":\"\",\"n\":3}", 0, error_t::bad);						}),
+	RUN("binary: misplaced padding", {
+		return runb(env, "{\"n\":3,\"fw\":\"AQ=D\"}",
+			"{\"fw\":\"\",\"n\":3}", 0, error_t::bad);						}),
+	RUN("binary: stream by blocks", {
+		return runs(env,
+			"\"AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJygpKiss"
+			"LS4vMDEyMzQ1Njc4OTo7PD0+P0BBQkNERUZHSElKS0xNTk9QUVJTVFVWV1hZ"
+			"WltcXV5fYGFiYw==\"", 100);										}),
+};
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 046.cpp - cojson tests, fixed-point decimal numbers
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+typedef decimal<5,2> d52;
+typedef decimal<4,0> d40;
+typedef decimal<18,9> d189;
+
+template<class T>
+static result_t rund(const Environment& env, const char_t* inp,
+		const char_t* answer, error_t expected = error_t::noerror) noexcept {
+	static char_t out[32];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	T val {};
+	bool r = reader<T>::read(val, in) || expected == error_t::bad;
+	r = writer<T>::write(val, dst) && dst.put(0) && r;
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+static result_t run52(const Environment& env, const char_t* inp,
+		const char_t* answer, error_t expected = error_t::noerror) noexcept {
+	return rund<d52>(env, inp, answer, expected);
+}
+
+static result_t runoverflow(const Environment& env) noexcept {
+	return
+		config::overflow == config::overflow_is::error ?
+			run52(env, "1234.5", "999.99", error_t::overflow) :
+		config::overflow == config::overflow_is::saturated ?
+			run52(env, "1234.5", "999.99") :
+			rund<d40>(env, "12345", "12345");
+}
+
+struct Test046 : Test {
+	static Test046 tests[];
+	inline Test046(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test046(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test046 Test046::tests[] = {
+	RUN("decimal: fraction padded", {
+		return run52(env, "21.5", "21.50");									}),
+	RUN("decimal: rounding half away from zero", {
+		return combinu(run52(env, "-0.125", "-0.13") |
+			run52(env, "1.005", "1.01"));								}),
+	RUN("decimal: exponent", {
+		return combinu(run52(env, "2.5e1", "25.00") |
+			run52(env, "12E-3 ", "0.01"));								}),
+	RUN("decimal: negative zero", {
+		return run52(env, "-0.001", "0.00");								}),
+	RUN("decimal: no fraction", {
+		return rund<d40>(env, "-42", "-42");								}),
+	RUN("decimal: eighteen digits", {
+		return rund<d189>(env, "123456789.123456789",
+			"123456789.123456789");											}),
+	RUN("decimal: malformed", {
+		return run52(env, "1.2.3", "0.00", error_t::bad);					}),
+	RUN("decimal: overflow", {
+		return runoverflow(env);											}),
+};
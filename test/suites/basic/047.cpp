@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 047.cpp - cojson tests, member order prediction
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+
+NAME(a)
+NAME(b)
+NAME(c)
+
+struct Pod47 {
+	int a;
+	int b;
+	int c;
+};
+
+static const clas<Pod47>& pod() noexcept {
+	return O<Pod47,
+		P<Pod47, a, int, &Pod47::a>,
+		P<Pod47, b, int, &Pod47::b>,
+		P<Pod47, c, int, &Pod47::c>
+	>();
+}
+
+/* consumer log: checksum of elements weighted by index + 1 */
+static long sum;
+
+static bool pods(const Pod47& v, unsigned i) noexcept {
+	sum += (v.a * 100 + v.b * 10 + v.c) * (i + 1);
+	return true;
+}
+
+static result_t runa(const Environment& env, const char_t* inp,
+		long answer, error_t expected = error_t::noerror) noexcept {
+	buffer src(inp);
+	lexer in(src);
+	sum = 0;
+	bool r = V<Pod47, pod, pods>().read(in);
+	bool m = sum == answer;
+	env.out(r && m, "%ld\n", sum);
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+static result_t runm(const Environment& env, const char_t* inp,
+		long answer, const char* marks) noexcept {
+	buffer src(inp);
+	lexer in(src);
+	Pod47 obj {};
+	bitmap<3> set;
+	bool r = pod().read(obj, in, set);
+	sum = 0;
+	pods(obj, 0);
+	bool m = sum == answer;
+	for(unsigned i = 0; i < 3; ++i)
+		m = m && set.test(i) == (marks[i] == '1');
+	env.out(r && m, "%ld\n", sum);
+	return combine2(r, m, in.error());
+}
+
+/* reads an object with trail, then checks the order it predicts	*/
+static result_t runt(const Environment& env, const char_t* inp,
+		const char* order) noexcept {
+	buffer src(inp);
+	lexer in(src);
+	Pod47 obj {};
+	trail t;
+	bool r = pod().read(obj, in, t);
+	bool m = true;
+	t.start();
+	for(unsigned i = 0; order[i] && m; ++i) {
+		m = t.predict() == static_cast<unsigned>(order[i] - '0');
+		t.matched(t.predict());
+	}
+	env.out(r && m, "%d%d%d\n", obj.a, obj.b, obj.c);
+	return combine2(r, m, in.error());
+}
+
+struct Test047 : Test {
+	static Test047 tests[];
+	inline Test047(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test047(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test047 Test047::tests[] = {
+	RUN("prediction: members in declaration order", {
+		return runa(env, "[{\"a\":1,\"b\":2,\"c\":3},{\"a\":4,\"b\":5,\"c\":6}]",
+			123 + 456 * 2);													}),
+	RUN("prediction: members in reverse order", {
+		return runa(env, "[{\"c\":3,\"b\":2,\"a\":1},{\"c\":6,\"b\":5,\"a\":4}]",
+			123 + 456 * 2);													}),
+	RUN("prediction: missing, repeated and unknown members", {
+		return runa(env, "[{\"b\":2,\"x\":9,\"c\":3,\"b\":7},{\"a\":4,\"a\":5}]",
+			73 + 500 * 2);											}),
+	RUN("prediction: elements changing the order", {
+		return runa(env, "[{\"b\":2,\"c\":3,\"a\":1},{\"b\":5,\"c\":6,\"a\":4},"
+			"{\"a\":7,\"b\":8,\"c\":9},{\"c\":3,\"a\":1,\"b\":2}]",
+			123 + 456 * 2 + 789 * 3 + 123 * 4);								}),
+	RUN("prediction: trail repeats the order of the last object", {
+		return runt(env, "{\"c\":3,\"a\":1,\"b\":2}", "201");			}),
+	RUN("prediction: trail follows declaration past the last object", {
+		return runt(env, "{\"b\":2}", "12");								}),
+	RUN("prediction: members marked in presence set", {
+		return runm(env, "{\"c\":3,\"a\":1}", 103, "101");					}),
+};
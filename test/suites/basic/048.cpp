@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 048.cpp - cojson tests, per-property number format
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+NAME(t)
+NAME(lat)
+NAME(r)
+NAME(s)
+
+struct Pod48 {
+	double t;
+	double lat;
+	float r;
+	double s;
+};
+
+static const clas<Pod48>& pod() noexcept {
+	return O<Pod48,
+		P<Pod48, t, double, &Pod48::t, format::fixed<1>>,
+		P<Pod48, lat, double, &Pod48::lat, format::fixed<7>>,
+		P<Pod48, r, float, &Pod48::r, format::significant<3>>,
+		P<Pod48, s, double, &Pod48::s, format::shortest>
+	>();
+}
+
+static double level;
+
+typedef accessor::pointer<double, &level> A48;
+
+static result_t runo(const Environment& env, const Pod48& obj,
+		const char_t* answer) noexcept {
+	static char_t out[96];
+	buffer dst(out);
+	bool r = pod().write(obj, dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, dst.error());
+}
+
+static result_t runv(const Environment& env, const details::value& val,
+		const char_t* inp, const char_t* answer, double expected) noexcept {
+	static char_t out[32];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	bool r = val.read(in) && val.write(dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0 && level == expected;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, in.error());
+}
+
+static result_t runfixed(const Environment& env) noexcept {
+	return runo(env, Pod48 { 21.46, 50.4501011, 0.15625f, 0.1 },
+		"{\"t\":21.5,\"lat\":50.4501011,\"r\":0.156,\"s\":0.1}");
+}
+
+static result_t runnegative(const Environment& env) noexcept {
+	return runo(env, Pod48 { -0.04, -30.52, 123.45f, 1.5 },
+		"{\"t\":0.0,\"lat\":-30.5200000,\"r\":123,\"s\":1.5}");
+}
+
+static result_t runscaled(const Environment& env) noexcept {
+	return combinu(runv(env, V<double, &level, format::scaled<100>>(),
+		"-2137", "-2137", -21.37) |
+		runv(env, V<A48, format::fixed<2>>(), "3.125", "3.13", 3.125));
+}
+
+struct Test048 : Test {
+	static Test048 tests[];
+	inline Test048(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test048(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test048 Test048::tests[] = {
+	RUN("format: fixed, significant and shortest properties", {
+		return runfixed(env);												}),
+	RUN("format: negative values", {
+		return runnegative(env);											}),
+	RUN("format: scaled and fixed values", {
+		return runscaled(env);												}),
+};
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 049.cpp - cojson tests, validation of JSON texts
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+/* validates inp as a whole, by single characters and from a stream,
+ * all three must agree on the result and the offset					*/
+static result_t runv(const Environment& env, const char_t* inp,
+		bool valid, unsigned offset) noexcept {
+	const unsigned n = strlen(inp);
+	unsigned at = 0, bychar = 0, bystream = 0;
+	bool r = validate(inp, n, &at) == valid;
+	validator v;
+	for(unsigned i = 0; i < n && v.feed(inp + i, 1); ++i);
+	r = r && (v.finish() == valid);
+	bychar = v.offset();
+	buffer src(inp);
+	r = r && validate(src, &bystream) == valid;
+	bool m = at == offset && bychar == offset && bystream == offset;
+	env.out(r && m, "%s at %u %u %u\n", valid ? "valid" : "invalid",
+		at, bychar, bystream);
+	return combine2(r, m, error_t::noerror);
+}
+
+static result_t rundeep(const Environment& env, unsigned depth,
+		bool valid) noexcept {
+	static char_t inp[2 * validator::maxdepth + 3];
+	unsigned n = 0;
+	for(unsigned i = 0; i < depth; ++i) inp[n++] = '[';
+	for(unsigned i = 0; i < depth; ++i) inp[n++] = ']';
+	inp[n] = 0;
+	return runv(env, inp, valid, valid ? n : validator::maxdepth);
+}
+
+struct Test049 : Test {
+	static Test049 tests[];
+	inline Test049(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test049(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test049 Test049::tests[] = {
+	RUN("validate: well-formed texts", {
+		return combinu(
+		runv(env, " {\"a\":[1,-2.5e+3,true,false,null],\"b\":{}} ", true, 42) |
+		runv(env, "[[],{},\"\",0]", true, 12) |
+		runv(env, "-0.5", true, 4));											}),
+	RUN("validate: structural errors", {
+		return combinu(
+		runv(env, "{\"a\":1,}", false, 7) |
+		runv(env, "[1 2]", false, 3) |
+		runv(env, "{\"a\" 1}", false, 5) |
+		runv(env, "[1}", false, 2) |
+		runv(env, "[1]]", false, 3) |
+		runv(env, "[1,", false, 3));											}),
+	RUN("validate: malformed tokens", {
+		return combinu(
+		runv(env, "[tru]", false, 4) |
+		runv(env, "[01]", false, 2) |
+		runv(env, "[1.5e]", false, 5) |
+		runv(env, "\"a\\x\"", false, 3) |
+		runv(env, "\"\\u12G4\"", false, 5));									}),
+	RUN("validate: UTF-8 in strings", {
+		return combinu(
+		runv(env, "[\"caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 long plain text\"]",
+			true, 34) |
+		runv(env, "\"\xC0\xAF\"", false, 1) |
+		runv(env, "\"\xED\xA0\x80\"", false, 2) |
+		runv(env, "\"\xF4\x90\x80\x80\"", false, 2) |
+		runv(env, "\"abcdefghijklmnop\xE2\x82\"", false, 19));			}),
+	RUN("validate: nesting depth", {
+		return combinu(rundeep(env, validator::maxdepth, true) |
+			rundeep(env, validator::maxdepth + 1, false));					}),
+};
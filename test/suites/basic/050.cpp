@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 050.cpp - cojson tests, minify and canonicalize filters
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+/* window = 0 selects minify, otherwise canonicalize with the window size */
+static result_t runf(const Environment& env, const char_t* inp,
+		const char_t* answer, unsigned window = 0,
+		error_t expected = error_t::noerror) noexcept {
+	static char_t out[128];
+	static char_t win[64];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	bool r = window ? canonicalize(in, dst, win, window) : minify(in, dst);
+	r = (r || expected == error_t::bad) && dst.put(0);
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+struct Test050 : Test {
+	static Test050 tests[];
+	inline Test050(cstring name, cstring desc, runner func) noexcept
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test050(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test050 Test050::tests[] = {
+	RUN("minify: insignificant whitespace", {
+		return runf(env, " { \"a\" : [ 1 , 2 , { } , [ ] ] ,\n\t\"b\" : \"x y\" } ",
+			"{\"a\":[1,2,{},[]],\"b\":\"x y\"}");							}),
+	RUN("minify: numbers", {
+		return runf(env, "[1.50,-0,1E+02,0.00100,-2.0e-05,-0.0e5,10,1e0]",
+			"[1.5,0,1e2,0.001,-2e-5,0,10,1]");								}),
+	RUN("minify: escapes", {
+		return runf(env,
+			"[\"\\u0041\\/\\u00e9\\t\\u001f\\ud83d\\ude00\\\"\",true,null]",
+			"[\"A/\xC3\xA9\\t\\u001F\xF0\x9F\x98\x80\\\"\",true,null]");	}),
+	RUN("canonicalize: keys sorted at every level", {
+		return runf(env,
+			"{\"b\":1,\"a\":{\"d\":[false,null],\"c\":\"\\\"\"},\"ab\":2}",
+			"{\"a\":{\"c\":\"\\\"\",\"d\":[false,null]},\"ab\":2,\"b\":1}",
+			64);															}),
+	RUN("canonicalize: object beyond the window keeps input order", {
+		return runf(env, "{\"b\":\"xxxxxxxxxxxxxxxxxx\", \"a\":{\"d\":2,\"c\":3}}",
+			"{\"b\":\"xxxxxxxxxxxxxxxxxx\",\"a\":{\"c\":3,\"d\":2}}", 24);		}),
+	RUN("minify: malformed input, nothing staged is written", {
+		return combinu(runf(env, "[1,]", "", 0, error_t::bad) |
+			runf(env, "{\"a\" 1}", "", 0, error_t::bad) |
+			runf(env, "\"\\ud83d\"", "", 0, error_t::bad));					}),
+};
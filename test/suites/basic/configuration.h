@@ -18,6 +18,15 @@ namespace configuration {
 	static constexpr write_double_impl_is write_double_impl =
 			write_double_impl_is::with_sprintf;
 #	endif
+#	ifdef TEST_NUMBER_MEMO
+		static constexpr auto number_memo = number_memo_is::previous;
+#	endif
+#	ifdef TEST_NUMBER_TABLE
+		static constexpr auto number_lexer = number_lexer_is::table;
+#	endif
+#	ifdef TEST_ABSENT_OMITTED
+		static constexpr auto absent = absent_is::omitted;
+#	endif
 #	ifdef CSTRING_PROGMEM
 		static constexpr cstring_is cstring = cstring_is::avr_progmem;
 	#endif
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 103.cpp - cojson tests, reading/writing std containers
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include "cojson_stdlib.hpp"
+#include "test.hpp"
+
+namespace cojson {
+namespace test {
+
+NAME(a)
+NAME(b)
+NAME(n)
+NAME(s)
+
+struct Item103 {
+	int n;
+	std::string s;
+};
+
+struct Pod103 {
+	std::string a;
+	std::vector<Item103> b;
+};
+
+static const clas<Item103>& item() noexcept {
+	return O<Item103,
+		P<Item103, n, int, &Item103::n>,
+		P<Item103, s, std::string, &Item103::s>
+	>();
+}
+
+static const clas<Pod103>& pod() noexcept {
+	return O<Pod103,
+		P<Pod103, a, std::string, &Pod103::a>,
+		P<Pod103, b, Item103, &Pod103::b, item>
+	>();
+}
+
+static std::vector<int>& ints() noexcept {
+	static std::vector<int> v;
+	return v;
+}
+
+static std::vector<Item103>& items() noexcept {
+	static std::vector<Item103> v;
+	return v;
+}
+
+static stddictionary<std::string>& names() noexcept {
+	static stddictionary<std::string> d;
+	return d;
+}
+
+typedef accessor::container<std::vector<Item103>, items> X103;
+typedef accessor::container<std::vector<int>, ints> I103;
+
+template<class F>
+static result_t runc(const Environment& env, const char_t* inp,
+		const char_t* answer, F read) noexcept {
+	static char_t out[128];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	bool r = read(in, dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, in.error());
+}
+
+struct Test103 : Test {
+	static Test103 tests[];
+	inline Test103(tstring name, tstring desc, runner func)
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test103(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test103 Test103::tests[] = {
+	RUN("std::vector<int>: read, shrink on reread", {
+		ints().assign(8, 0);
+		return runc(env, "[1, 2, 3]", "[1,2,3]",
+			[](lexer& in, ostream& out) noexcept {
+				return cojson::V<std::vector<int>, ints>().read(in) &&
+					ints().capacity() >= 8 &&
+					cojson::V<std::vector<int>, ints>().write(out);
+			});																}),
+	RUN("std::vector<int>: empty", {
+		return runc(env, "[]", "[]",
+			[](lexer& in, ostream& out) noexcept {
+				return cojson::V<std::vector<int>, ints>().read(in) &&
+					cojson::V<std::vector<int>, ints>().write(out);
+			});																}),
+	RUN("std::string and vector of objects as properties", {
+		return runc(env,
+			"{\"a\":\"escaped \\\"string\\\"\",\"b\":[{\"n\":1,\"s\":\"one\"},"
+			"{\"s\":\"two\",\"n\":2}]}",
+			"{\"a\":\"escaped \\\"string\\\"\",\"b\":[{\"n\":1,\"s\":\"one\"},"
+			"{\"n\":2,\"s\":\"two\"}]}",
+			[](lexer& in, ostream& out) noexcept {
+				Pod103 obj;
+				return pod().read(obj, in) && obj.b.size() == 2 &&
+					pod().write(obj, out);
+			});																}),
+	RUN("accessor::container of objects", {
+		items().resize(3);
+		items()[0].s.reserve(64);
+		return runc(env,
+			"[{\"n\":10,\"s\":\"ten\"},{\"n\":20,\"s\":\"twenty\"}]",
+			"[{\"n\":10,\"s\":\"ten\"},{\"n\":20,\"s\":\"twenty\"}]",
+			[](lexer& in, ostream& out) noexcept {
+				return cojson::V<X103, item>().read(in) && items().size() == 2 &&
+					items()[0].s.capacity() >= 64 && /* element reused */
+					cojson::V<X103, item>().write(out);
+			});																}),
+	RUN("accessor::container as a member", {
+		return runc(env, "{\"a\":[4,5]}", "{\"a\":[4,5]}",
+			[](lexer& in, ostream& out) noexcept {
+				return cojson::V<cojson::M<a, I103>>().read(in) &&
+					ints().size() == 2 &&
+					cojson::V<cojson::M<a, I103>>().write(out);
+			});																}),
+	RUN("arena_string in a scratch arena", {
+		return runc(env, "\"arena allocated string\"",
+			"\"arena allocated string\"",
+			[](lexer& in, ostream& out) noexcept {
+				static char scratch[64];
+				arena mem(scratch);
+				bool r;
+				{
+					arena_string str { arena_allocator<char_t>(&mem) };
+					r = reader<arena_string>::read(str, in) &&
+						mem.owns(str.data()) &&
+						writer<arena_string>::write(str, out);
+				}
+				mem.reset();
+				return r;
+			});																}),
+	RUN("std::string: null", {
+		return runc(env, "null", "\"\"",
+			[](lexer& in, ostream& out) noexcept {
+				std::string str("not empty");
+				return reader<std::string>::read(str, in) &&
+					writer<std::string>::write(str, out);
+			});																}),
+	RUN("stddictionary: grows beyond initial index", {
+		return runc(env,
+			"{\"k1\":\"a\",\"k2\":\"b\",\"k3\":\"c\",\"k4\":\"d\","
+			"\"k5\":\"e\",\"k6\":\"f\",\"k7\":\"g\",\"k2\":\"B\"}",
+			"{\"k1\":\"a\",\"k2\":\"B\",\"k3\":\"c\",\"k4\":\"d\","
+			"\"k5\":\"e\",\"k6\":\"f\",\"k7\":\"g\"}",
+			[](lexer& in, ostream& out) noexcept {
+				return reader<stddictionary<std::string>>::read(names(), in) &&
+					names().count() == 7 && *names().find("k5") == "e" &&
+					writer<stddictionary<std::string>>::write(names(), out);
+			});																}),
+};
+
+}}
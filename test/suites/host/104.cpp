@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 104.cpp - cojson tests, number grammar with the numlexer table
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+
+/* numlexer table follows RFC 7159 strictly, chartype accepts some
+ * malformed numbers. The numlex goal runs these tests with the table */
+static constexpr bool strict =
+	config::number_lexer == config::number_lexer_is::table;
+
+template<typename T>
+static result_t runn(const Environment& env, const char_t* inp, T answer,
+		error_t expected = error_t::noerror) noexcept {
+	buffer src(inp);
+	lexer in(src);
+	T val = 0;
+	bool r = reader<T>::read(val, in);
+	bool m = expected != error_t::noerror || val == answer;
+	if( expected != error_t::noerror ) r = ! r;
+	env.out(r && m, fmt<T>(), val);
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+struct Test104 : Test {
+	static Test104 tests[];
+	inline Test104(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test104(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test104 Test104::tests[] = {
+	RUN("number grammar: exponent with sign", {
+		return runn<double>(env, "-1.5e+2", -150.);						}),
+	RUN("number grammar: negative exponent", {
+		return runn<double>(env, "25E-2 ", .25);							}),
+	RUN("number grammar: minus zero", {
+		return runn<int>(env, "-0", 0);										}),
+	RUN("number grammar: leading zero", {
+		return strict ? runn<int>(env, "01", 0, error_t::bad)
+					  : runn<int>(env, "01", 1);								}),
+	RUN("number grammar: lone minus", {
+		return strict ? runn<double>(env, "-]", 0., error_t::bad)
+					  : runn<double>(env, "-]", 0.);							}),
+	RUN("number grammar: double minus", {
+		return runn<long>(env, "--1", 0, error_t::bad);						}),
+	RUN("number grammar: incomplete exponent", {
+		if( strict ) return runn<double>(env, "1e", 0., error_t::bad);
+		/* chartype fails too, but does not tell the error				*/
+		buffer src("1e");
+		lexer in(src);
+		double val = 0;
+		bool r = ! reader<double>::read(val, in);
+		env.out(r, fmt<double>(), val);
+		return combine1(r, in.error());										}),
+	RUN("number grammar: fraction into integer", {
+		return runn<int>(env, "1.5", 0, error_t::mismatch);					}),
+	RUN("number grammar: negative into unsigned", {
+		return runn<unsigned>(env, "-1", 0, error_t::mismatch);				}),
+};
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 105.cpp - cojson tests, runtime-defined schemas
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "cojson_schema.hpp"
+#include "test.hpp"
+
+namespace cojson {
+namespace test {
+
+struct Point105 {
+	int32_t x;
+	int32_t y;
+};
+
+struct Device105 {
+	char_t name[12];
+	bool on;
+	uint16_t port;
+	double level;
+	int8_t codes[3];
+	Point105 origin;
+	Point105 path[2];
+	char_t tags[2][6];
+};
+
+static const schema& point() noexcept {
+	static const schema s = schema::builder()
+		.scalar("x", fieldtype::int32, offsetof(Point105, x))
+		.scalar("y", fieldtype::int32, offsetof(Point105, y))
+		.build();
+	return s;
+}
+
+static const schema& device() noexcept {
+	static const schema s = schema::builder()
+		.string("name", offsetof(Device105, name), 12)
+		.scalar("on", fieldtype::boolean, offsetof(Device105, on))
+		.scalar("port", fieldtype::uint16, offsetof(Device105, port))
+		.scalar("level", fieldtype::float64, offsetof(Device105, level))
+		.array("codes", fieldtype::int8, offsetof(Device105, codes), 3)
+		.object("origin", offsetof(Device105, origin), point())
+		.objects("path", offsetof(Device105, path), 2, sizeof(Point105),
+				point())
+		.strings("tags", offsetof(Device105, tags), 2, 6)
+		.build();
+	return s;
+}
+
+static result_t runs(const Environment& env, const char_t* inp,
+		const char_t* answer, error_t expected = error_t::noerror) noexcept {
+	static char_t out[256];
+	Device105 dev {};
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	bool r = device().read(&dev, in);
+	r = device().write(&dev, dst) && dst.put(0) && r;
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+struct Test105 : Test {
+	static Test105 tests[];
+	inline Test105(tstring name, tstring desc, runner func)
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test105(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test105 Test105::tests[] = {
+	RUN("runtime schema: all kinds of fields", {
+		return runs(env,
+			"{\"path\":[{\"x\":1,\"y\":2},{\"y\":4,\"x\":3}],\"level\":0.5,"
+			"\"origin\":{\"x\":-7,\"y\":7},\"codes\":[-1,0,1],"
+			"\"tags\":[\"ab\",\"cd\"],\"on\":true,\"port\":8080,"
+			"\"name\":\"dev\",\"unknown\":{\"x\":1}}",
+			"{\"name\":\"dev\",\"on\":true,\"port\":8080,\"level\":0.5,"
+			"\"codes\":[-1,0,1],\"origin\":{\"x\":-7,\"y\":7},"
+			"\"path\":[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4}],"
+			"\"tags\":[\"ab\",\"cd\"]}");										}),
+	RUN("runtime schema: array overrun", {
+		return runs(env, "{\"codes\":[1,2,3,4],\"port\":1}",
+			"{\"name\":\"\",\"on\":false,\"port\":1,\"level\":0,"
+			"\"codes\":[1,2,3],\"origin\":{\"x\":0,\"y\":0},"
+			"\"path\":[{\"x\":0,\"y\":0},{\"x\":0,\"y\":0}],"
+			"\"tags\":[\"\",\"\"]}", error_t::overrun);						}),
+	RUN("runtime schema: find by name", {
+		const schema::field* f = device().find("level");
+		bool m = f != nullptr && f->offset == offsetof(Device105, level) &&
+			device().find("levels") == nullptr && device().size() == 8;
+		env.out(m, "%s\n", f ? f->name.c_str() : "(null)");
+		return combine2(true, m, error_t::noerror);							}),
+};
+
+}}
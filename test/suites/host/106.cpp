@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 106.cpp - cojson tests, enumnames lookup tables
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+
+#include <string.h>
+#include "enumnames.hpp"
+#include "test.hpp"
+
+namespace enumnames {
+	bool match(const char* a, const char* b) noexcept {
+		return strcmp(a, b) == 0;
+	}
+}
+
+enum class pin106 { in, out, pullup, pulldown, __unknown__ };
+enum sparse106 { lo106 = -5, hi106 = 5000 };
+
+namespace names106 {
+	constexpr const char* in() noexcept { return "in"; }
+	constexpr const char* out() noexcept { return "out"; }
+	constexpr const char* pullup() noexcept { return "pullup"; }
+	constexpr const char* pulldn() noexcept { return "pulldn"; }
+}
+
+template<pin106 K, enumnames::name V>
+struct _106 : enumnames::tuple<pin106, K, V> {};
+
+struct pins106 : enumnames::names<pin106,
+	_106<pin106::in,			names106::in>,
+	_106<pin106::out,			names106::out>,
+	_106<pin106::pullup,		names106::pullup>,
+	_106<pin106::pulldown,		names106::pulldn>,
+	_106<pin106::__unknown__,	nullptr>> {
+};
+
+struct sparse106s : enumnames::names<sparse106,
+	enumnames::tuple<sparse106, lo106, names106::in>,
+	enumnames::tuple<sparse106, hi106, names106::out>> {
+};
+
+struct dups106 : enumnames::names<pin106,
+	_106<pin106::in,			names106::in>,
+	_106<pin106::out,			names106::in>,
+	_106<pin106::__unknown__,	nullptr>> {
+};
+
+/* lookups by key and by index remain usable in constant expressions */
+static_assert(pins106::get(pin106::pullup)[0] == 'p' &&
+	pins106::get(pin106::__unknown__)[0] == 0 &&
+	sparse106s::get(hi106)[0] == 'o' &&
+	pins106::get(1u)[0] == 'o' && pins106::get(4u) == nullptr,
+	"constexpr lookup");
+
+template<class N>
+static result_t rune(const Environment& env, const char* nam,
+		typename N::type key, const char* back) noexcept {
+	typename N::type k = N::get(nam);
+	const char* s = N::get(k);
+	bool m = k == key && strcmp(s, back) == 0;
+	env.out(m, "%d '%s'\n", static_cast<int>(k), s);
+	return combine2(true, m, error_t::noerror);
+}
+
+struct Test106 : Test {
+	static Test106 tests[];
+	inline Test106(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test106(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test106 Test106::tests[] = {
+	RUN("enumnames: hashed name to key and indexed key to name", {
+		return rune<pins106>(env, "pulldn", pin106::pulldown, "pulldn");	}),
+	RUN("enumnames: unknown name maps to the last key", {
+		return rune<pins106>(env, "pull", pin106::__unknown__, "");		}),
+	RUN("enumnames: name by ordinal", {
+		bool m = strcmp(pins106::get(1u), "out") == 0 &&
+			pins106::get(4u) == nullptr && pins106::get(5u) == nullptr;
+		env.out(m, "%s\n", pins106::get(1u));
+		return combine2(true, m, error_t::noerror);							}),
+	RUN("enumnames: sparse keys", {
+		return rune<sparse106s>(env, "out", hi106, "out");					}),
+	RUN("enumnames: duplicate names fall back to linear search", {
+		return rune<dups106>(env, "in", pin106::in, "in");					}),
+};
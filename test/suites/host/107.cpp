@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 107.cpp - cojson tests, snapshot accessors for concurrent state
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include <thread>
+#include "cojson_concurrent.hpp"
+#include "test.hpp"
+
+namespace cojson {
+namespace test {
+
+NAME(lo)
+NAME(hi)
+NAME(count)
+
+struct Range107 {
+	long lo;
+	long hi;
+};
+
+struct Station107 {
+	seqlock<long> count;
+};
+
+static seqlock<long> counter;
+static doublebuffer<Range107> latest;
+static seqlock<Range107> locked;
+static Station107 station;
+
+static const clas<Range107>& rangec() noexcept {
+	return O<Range107,
+		P<Range107, lo, long, &Range107::lo>,
+		P<Range107, hi, long, &Range107::hi>
+	>();
+}
+
+static const clas<Station107>& stationc() noexcept {
+	return O<Station107,
+		P<Station107, count, accessor::snapshotfield<Station107,
+			seqlock<long>, &Station107::count>>
+	>();
+}
+
+typedef accessor::snapshot<seqlock<long>, &counter> C107;
+typedef accessor::snapshot<doublebuffer<Range107>, &latest> L107;
+typedef accessor::snapshot<seqlock<Range107>, &locked> S107;
+
+template<class F>
+static result_t runs(const Environment& env, const char_t* inp,
+		const char_t* answer, F read,
+		error_t expected = error_t::noerror) noexcept {
+	static char_t out[128];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	bool r = read(in, dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, Test::expected(in.error(), expected));
+}
+
+static bool rangeread(lexer& in, ostream& out) noexcept {
+	latest.store(Range107 { 1, 2 });
+	return cojson::V<L107, rangec>().read(in) &&
+		cojson::V<L107, rangec>().write(out);
+}
+
+static bool rangeput(lexer& in, ostream& out) noexcept {
+	latest.store(Range107 { 1, 2 });
+	return ! cojson::V<L107, rangec>().read(in) &&
+		cojson::V<L107, rangec>().write(out);
+}
+
+/* producer keeps lo == -hi, a torn snapshot would break it */
+static result_t concurrent(const Environment& env) noexcept {
+	std::atomic<bool> done(false);
+	std::thread producer([&done]() noexcept {
+		for(long n = 1; ! done.load(std::memory_order_relaxed); ++n)
+			locked.store(Range107 { n, -n });
+	});
+	unsigned torn = 0;
+	bool r = true;
+	for(unsigned i = 0; i < 5000 && r; ++i) {
+		char_t out[64];
+		buffer dst(out);
+		r = cojson::V<S107, rangec>().write(dst) && dst.put(0);
+		Range107 got { 0, 1 };
+		buffer src(out);
+		lexer in(src);
+		r = r && rangec().read(got, in);
+		if( got.lo != -got.hi ) ++torn;
+	}
+	done.store(true);
+	producer.join();
+	env.out(r && torn == 0, "torn snapshots: %u\n", torn);
+	return combine2(r, torn == 0, error_t::noerror);
+}
+
+struct Test107 : Test {
+	static Test107 tests[];
+	inline Test107(tstring name, tstring desc, runner func)
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test107(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test107 Test107::tests[] = {
+	RUN("seqlock scalar: read publishes, write snapshots", {
+		return runs(env, "42", "42", [](lexer& in, ostream& out) noexcept {
+			return cojson::V<C107>().read(in) && counter.load() == 42 &&
+				cojson::V<C107>().write(out);
+		});																	}),
+	RUN("doublebuffer object: absent members retain values", {
+		return runs(env, "{\"hi\":20}", "{\"lo\":1,\"hi\":20}", rangeread);	}),
+	RUN("doublebuffer object: malformed input is not published", {
+		return runs(env, "{\"lo\":10,\"hi\":}", "{\"lo\":1,\"hi\":2}",
+			rangeput, error_t::bad);										}),
+	RUN("snapshotfield as a class property", {
+		return runs(env, "{\"count\":7}", "{\"count\":7}",
+			[](lexer& in, ostream& out) noexcept {
+				return stationc().read(station, in) &&
+					station.count.load() == 7 &&
+					stationc().write(station, out);
+			});																}),
+	RUN("seqlock object: snapshots under concurrent stores", {
+		return concurrent(env);												}),
+};
+
+}}
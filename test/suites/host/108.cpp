@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 108.cpp - cojson tests, atomic and sharded counter accessors
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include <thread>
+#include "cojson_concurrent.hpp"
+#include "test.hpp"
+
+namespace cojson {
+namespace test {
+
+NAME(hits)
+NAME(errors)
+
+struct Metrics108 {
+	std::atomic<unsigned> hits;
+	std::atomic<int> errors;
+};
+
+static std::atomic<long> level;
+static counter<unsigned long> requests;
+static Metrics108 metrics;
+
+static const clas<Metrics108>& metricsc() noexcept {
+	return O<Metrics108,
+		P<Metrics108, hits, accessor::atomicfield<Metrics108, unsigned,
+			&Metrics108::hits>>,
+		P<Metrics108, errors, accessor::atomicfield<Metrics108, int,
+			&Metrics108::errors>>
+	>();
+}
+
+typedef accessor::atomic<long, &level> A108;
+typedef accessor::snapshot<counter<unsigned long>, &requests> C108;
+
+template<class F>
+static result_t runa(const Environment& env, const char_t* inp,
+		const char_t* answer, F read) noexcept {
+	static char_t out[64];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	bool r = read(in, dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, in.error());
+}
+
+static bool increments(lexer& in, ostream& out) noexcept {
+	std::thread threads[4];
+	for(auto& t : threads)
+		t = std::thread([]() noexcept {
+			for(unsigned i = 0; i < 10000; ++i) requests.add();
+		});
+	for(auto& t : threads) t.join();
+	return cojson::V<C108>().write(out) && out.put(' ') &&
+		cojson::V<C108>().read(in) && cojson::V<C108>().write(out);
+}
+
+struct Test108 : Test {
+	static Test108 tests[];
+	inline Test108(tstring name, tstring desc, runner func)
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test108(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test108 Test108::tests[] = {
+	RUN("std::atomic<long> via pointer", {
+		return runa(env, "-5", "-5", [](lexer& in, ostream& out) noexcept {
+			return cojson::V<A108>().read(in) && level.load() == -5 &&
+				cojson::V<A108>().write(out);
+		});																	}),
+	RUN("std::atomic members as class properties", {
+		return runa(env, "{\"errors\":-1}", "{\"hits\":3,\"errors\":-1}",
+			[](lexer& in, ostream& out) noexcept {
+				metrics.hits += 3;
+				return metricsc().read(metrics, in) &&
+					metricsc().write(metrics, out);
+			});																}),
+	RUN("sharded counter: increments from threads, reset via read", {
+		return runa(env, "0", "40000 0", increments);						}),
+	RUN("sharded counter: shards occupy separate cache lines", {
+		bool m = sizeof(requests) == 16 * counter<unsigned long>::cacheline;
+		env.out(m, "%u\n", static_cast<unsigned>(sizeof(requests)));
+		return combine2(true, m, error_t::noerror);							}),
+};
+
+}}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 109.cpp - cojson tests, compile-time chartype table
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+static_assert(config::chartype == config::chartype_is::inlined,
+	"host tests expect inlined chartype table");
+
+/* compares the constexpr table with the one built at run time */
+static result_t runt(const Environment& env, unsigned from, unsigned to)
+		noexcept {
+	unsigned c = from;
+	while( c <= to && +ctypeof(static_cast<char_t>(c)) ==
+			+chartype(static_cast<char_t>(c)) ) ++c;
+	bool m = c > to;
+	env.out(m, "%#x: %#x vs %#x\n", c,
+		m ? 0 : +ctypeof(static_cast<char_t>(c)),
+		m ? 0 : +chartype(static_cast<char_t>(c)));
+	return combine2(true, m, error_t::noerror);
+}
+
+static result_t runs(const Environment& env, const char_t* inp,
+		const char_t* answer) noexcept {
+	static char_t out[32];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	bool r = minify(in, dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, in.error());
+}
+
+struct Test109 : Test {
+	static Test109 tests[];
+	inline Test109(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test109(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test109 Test109::tests[] = {
+	RUN("chartype table: 7-bit characters match chartypetable", {
+		return runt(env, 0, 127);											}),
+	RUN("chartype table: high octets are string characters", {
+		return runt(env, 128, 255);											}),
+	RUN("chartype table: high octets pass through strings", {
+		return runs(env, "[ \"\xC3\xA9\xFF\" ]", "[\"\xC3\xA9\xFF\"]");		}),
+};
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 110.cpp - cojson tests, memo of short number tokens
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+#include <string.h>
+
+/* memo is transparent, so the answers hold with and without it,
+ * build goal memo runs these tests with the memo enabled					*/
+
+NAME(a)
+NAME(b)
+NAME(c)
+
+struct Pod110 {
+	int a;
+	int b;
+	double c;
+};
+
+static const clas<Pod110>& pod() noexcept {
+	return O<Pod110,
+		P<Pod110, a, int, &Pod110::a>,
+		P<Pod110, b, int, &Pod110::b>,
+		P<Pod110, c, double, &Pod110::c>
+	>();
+}
+
+/* reads numbers one by one, separated by whitespace */
+template<typename T>
+static result_t runn(const Environment& env, buffer& src,
+		const T* answers, unsigned n) noexcept {
+	lexer in(src);
+	unsigned i = 0;
+	T val;
+	while( i < n && reader<T>::read(val, in) && val == answers[i] ) ++i;
+	bool m = i == n;
+	env.out(m, "%u of %u\n", i, n);
+	return combine2(true, m, Test::expected(in.error(), error_t::eof));
+}
+
+static result_t runints(const Environment& env) noexcept {
+	static const long answers[] = { 12, 12, 12, 123, 12, -12, -12 };
+	buffer src("12 12\t12 123 12 -12 -12");
+	return runn(env, src, answers, countof(answers));
+}
+
+static result_t rundoubles(const Environment& env) noexcept {
+	static const double answers[] = { 0.1, 0.1, 0.10, 1e-3, 1e-3, 2.5e2 };
+	buffer src("0.1 0.1 0.10 1e-3 1e-3 2.5e2");
+	return runn(env, src, answers, countof(answers));
+}
+
+static result_t runsized(const Environment& env) noexcept {
+	static const int answers[] = { 77, 77, 7 };
+	static char_t data[] = "77 77 777";
+	buffer src(data, 7);
+	return runn(env, src, answers, countof(answers));
+}
+
+/* same token, different types */
+static result_t runtypes(const Environment& env) noexcept {
+	buffer src("300 300");
+	lexer in(src);
+	int i = 0;
+	signed char c = 0;
+	bool r = reader<int>::read(i, in);
+	bool e = ! reader<signed char>::read(c, in) ||
+		(in.error() & error_t::overflow) != error_t::noerror ||
+		config::overflow == config::overflow_is::ignored;
+	env.out(r && e, "%d %d\n", i, c);
+	return combine2(r, i == 300 && e, error_t::noerror);
+}
+
+static result_t runobject(const Environment& env) noexcept {
+	static char_t out[64];
+	buffer src("{\"a\":42,\"b\":42 , \"c\":42}");
+	buffer dst(out);
+	lexer in(src);
+	Pod110 obj {};
+	bool r = pod().read(obj, in);
+	r = pod().write(obj, dst) && dst.put(0) && r;
+	bool m = strcmp(out, "{\"a\":42,\"b\":42,\"c\":42}") == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, in.error());
+}
+
+struct Test110 : Test {
+	static Test110 tests[];
+	inline Test110(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test110(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test110 Test110::tests[] = {
+	RUN("number memo: repeated integers", {
+		return runints(env);												}),
+	RUN("number memo: repeated doubles", {
+		return rundoubles(env);												}),
+	RUN("number memo: token cut by the end of a sized buffer", {
+		return runsized(env);												}),
+	RUN("number memo: same token read as another type", {
+		return runtypes(env);												}),
+	RUN("number memo: delimiters after recalled members", {
+		return runobject(env);												}),
+};
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 111.cpp - cojson tests, reading/writing std::optional (C++17)
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+/* std::optional needs C++17, these tests run with the cpp17 goal */
+#if __cplusplus >= 201703L
+#include <string.h>
+#include "cojson_stdlib.hpp"
+#include "test.hpp"
+
+namespace cojson {
+namespace test {
+
+NAME(n)
+NAME(s)
+
+struct Pod111 {
+	int n;
+	std::optional<std::string> s;
+};
+
+static const clas<Pod111>& pod() noexcept {
+	return O<Pod111,
+		P<Pod111, n, int, &Pod111::n>,
+		P<Pod111, s, std::optional<std::string>, &Pod111::s>
+	>();
+}
+
+template<class F>
+static result_t runo(const Environment& env, const char_t* inp,
+		const char_t* answer, F read) noexcept {
+	static char_t out[64];
+	buffer src(inp);
+	buffer dst(out);
+	lexer in(src);
+	bool r = read(in, dst) && dst.put(0);
+	bool m = strcmp(out, answer) == 0;
+	env.out(r && m, "%s\n", out);
+	return combine2(r, m, in.error());
+}
+
+struct Test111 : Test {
+	static Test111 tests[];
+	inline Test111(tstring name, tstring desc, runner func)
+	  : Test(name, desc,func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+};
+
+#define RUN(name, body) Test111(OMIT(__FILE__),OMIT(name), \
+		[](const Environment& env) noexcept -> result_t body)
+
+Test111 Test111::tests[] = {
+	RUN("std::optional<int>: value read into empty", {
+		return runo(env, "42", "42",
+			[](lexer& in, ostream& out) noexcept {
+				std::optional<int> v;
+				return reader<std::optional<int>>::read(v, in) && v &&
+					writer<std::optional<int>>::write(v, out);
+			});																}),
+	RUN("std::optional<int>: null resets", {
+		return runo(env, "null", "null",
+			[](lexer& in, ostream& out) noexcept {
+				std::optional<int> v = 5;
+				return reader<std::optional<int>>::read(v, in) && ! v &&
+					writer<std::optional<int>>::write(v, out);
+			});																}),
+	RUN("std::optional<std::string> as property", {
+		return runo(env, "{\"n\":1,\"s\":\"one\"}", "{\"n\":1,\"s\":\"one\"}",
+			[](lexer& in, ostream& out) noexcept {
+				Pod111 obj;
+				return pod().read(obj, in) && obj.s && pod().write(obj, out);
+			});																}),
+	RUN("std::optional<std::string> property set to null", {
+		return runo(env, "{\"s\":null,\"n\":2}", "{\"n\":2,\"s\":null}",
+			[](lexer& in, ostream& out) noexcept {
+				Pod111 obj { 0, std::string("set") };
+				return pod().read(obj, in) && ! obj.s && pod().write(obj, out);
+			});																}),
+};
+
+}
+}
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 014.cpp - µcuREST tests, request heads in a contiguous buffer
+ *
+ * This file is part of µcuREST Library. http://hutorny.in.ua/projects/micurest
+ *
+ * The µcuREST Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The µcuREST Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "micurest.hpp"
+#include "test.hpp"
+using namespace micurest;
+
+static const directory& root() noexcept;
+
+struct Test014 : Test {
+	static Test014 tests[];
+	inline Test014(tstring name, tstring desc, cstring input) noexcept
+		: Test(name, desc), inp(input), expected(application::result_t::close){}
+	inline Test014(tstring name, tstring desc, cstring input,
+			application::result_t expect) noexcept
+		: Test(name, desc), inp(input), expected(expect){}
+	int index() const noexcept  {
+		return (this-tests);
+	}
+	/* services requests in the buffer one after another, as a keep-alive
+	 * connection would do */
+	result_t run(const Environment& env) const noexcept {
+		buffer in(inp);
+		application app(root(), true);
+		cleanup();
+		application::result_t res;
+		do
+			res = app.service(in, env.output);
+		while( res == application::result_t::keep && in.ahead(1) );
+		return res == expected ? success : (result_t)(bad | (uint8_t)res);
+	}
+	static void cleanup() noexcept;
+	cstring master() const noexcept;
+	cstring const inp;
+	application::result_t expected;
+};
+
+/* Test plan
+ * The same requests as in 010.cpp, but given in a contiguous buffer, are
+ * parsed by the word-at-a-time scan. Heads that are incomplete or do not
+ * fit the scan fall back to the character state machine.
+ * Responses must not depend on the parsing path.
+ */
+
+namespace name {
+NAME(natural)
+NAME(numeric)
+NAME(text)
+NAME(dir)
+}
+
+using namespace cojson::accessor;
+static unsigned natural;
+static float numeric;
+char_t text14[32];
+
+void Test014::cleanup() noexcept {
+	natural = 0;
+	numeric = 0;
+	memset(text14,0,sizeof(text14));
+}
+
+static float get_numeric() noexcept { return numeric; }
+static void put_numeric(float v) noexcept { numeric = v; }
+
+static const directory& root() noexcept {
+	return Root<
+		F<name::natural, pointer<unsigned, &natural>>,
+		F<name::numeric, pointer<float, &numeric>>,
+		D<name::dir,
+			F<name::natural, unsigned, &natural>,
+			F<name::numeric, float, get_numeric, put_numeric>,
+			F<name::text, countof(text14), text14>
+		>
+	>();
+}
+
+#define RUN(name, input) Test014(OMIT(__FILE__),OMIT(name), CSTR(input))
+#define NEG(name, input, result) Test014(OMIT(__FILE__),OMIT(name), CSTR(input), result)
+
+Test014 Test014::tests[] = {
+	RUN("GET /natural, unknown fields skipped",
+		"GET /natural HTTP/1.1\r\n"
+		"Host: localhost:8080\r\n"
+		"User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:52.0)\r\n"
+		"Accept: application/json\r\n"
+		"Accept-Language: en-US,en;q=0.5\r\n"
+		"Cache-Control: no-cache\r\n\r\n"),
+	NEG("GET /natural, keep-alive polling",
+		"GET /natural HTTP/1.1\r\nConnection: keep-alive\r\n\r\n"
+		"GET /natural HTTP/1.1\r\nConnection: Keep-Alive\r\n\r\n"
+		"GET /natural HTTP/1.1\r\nConnection: keep-alive\r\n\r\n",
+		application::result_t::keep),
+	RUN("PUT /dir/natural, then GET",
+		"PUT /dir/natural HTTP/1.1\r\n"
+		"Content-Type: application/json\r\n"
+		"Content-Length: 7\r\n"
+		"Connection: keep-alive\r\n\r\n65535\r\n"
+		"GET /dir/natural HTTP/1.1\r\nConnection: close\r\n\r\n"),
+	RUN("PUT /dir/text length, then GET",
+		"PUT /dir/text HTTP/1.0\r\n"
+		"Content-Type: text/plain\r\n"
+		"Content-Length: 6\r\n"
+		"Connection: keep-alive\r\n\r\nsingle"
+		"GET /dir/text HTTP/1.0\r\nAccept: text/plain\r\n\r\n"),
+	RUN("GET /numeric, LF only",
+		"GET /numeric HTTP/1.0\nAccept: text/plain\n\n"),
+	RUN("GET /dir/text, percent-encoded",
+		"GET /dir/%74ext HTTP/0.1\r\nIf-None-Match: 1234\r\n\r\n"),
+	RUN("POST /numeric, no version",
+		"POST /numeric\r\nContent-Type: application/json\r\n\r\n2.5\r\n"),
+	NEG("PATCH /natural, not implemented",
+		"PATCH /natural HTTP/1.1\r\n\r\n", application::result_t::bad),
+	NEG("GET /natural HTTP/2.0",
+		"GET /natural HTTP/2.0\r\n\r\n", application::result_t::bad),
+	NEG("GET /natural, folded field",
+		"GET /natural HTTP/1.1\r\n Accept: text/plain\r\n\r\n",
+		application::result_t::bad),
+//10
+	NEG("GET /natural, bad connection option",
+		"GET /natural HTTP/1.1\r\nConnection: upgrade\r\n\r\n",
+		application::result_t::bad),
+	NEG("GET /missing",
+		"GET /missing HTTP/1.1\r\n\r\n", application::result_t::bad),
+	NEG("GET /natural, head is not complete",
+		"GET /natural HTTP/1.1\r\nAccept: text/plain\r\n",
+		application::result_t::bad),
+};
+
+#undef _T_
+#define _T_ (1400)
+
+static cstring const Master[countof(Test014::tests)] = {
+	 _P_( 0), _P_( 1), _P_( 2), _P_( 3), _P_( 4),
+	 _P_( 5), _P_( 6), _P_( 7), _P_( 8), _P_( 9),
+	 _P_(10), _P_(11), _P_(12), //_P_(13), _P_(14),
+};
+
+#include "014.inc"
+
+cstring Test014::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 015.cpp - µcuREST tests, response heads
+ *
+ * This file is part of µcuREST Library. http://hutorny.in.ua/projects/micurest
+ *
+ * The µcuREST Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The µcuREST Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "micurest.hpp"
+#include "test.hpp"
+using namespace micurest;
+
+static const directory& root() noexcept;
+
+struct Test015 : Test {
+	static Test015 tests[];
+	inline Test015(tstring name, tstring desc, cstring input) noexcept
+		: Test(name, desc), inp(input), expected(application::result_t::close){}
+	inline Test015(tstring name, tstring desc, cstring input,
+			application::result_t expect) noexcept
+		: Test(name, desc), inp(input), expected(expect){}
+	int index() const noexcept  {
+		return (this-tests);
+	}
+	result_t run(const Environment& env) const noexcept {
+		buffer in(inp);
+		application app(root(), true);
+		application::result_t res;
+		do
+			res = app.service(in, env.output);
+		while( res == application::result_t::keep && in.ahead(1) );
+		return res == expected ? success : (result_t)(bad | (uint8_t)res);
+	}
+	cstring master() const noexcept;
+	cstring const inp;
+	application::result_t expected;
+};
+
+/* Test plan
+ * Response heads are rendered once per version, status, media type and
+ * connection option, and reused from the cache afterwards.
+ * Content-Length, ETag and fields added by the node are written around
+ * the rendered head. Repeated requests check that reused heads are
+ * the same as rendered ones.
+ */
+
+namespace name {
+NAME(tagged)
+NAME(extra)
+}
+
+/* a node with a fixed length body and an entity tag */
+struct Tagged : resource::node {
+	media::type mediatype() const noexcept { return media::plain; }
+	void get(micurest::details::message& msg) const noexcept {
+		msg.set_content_length(2);
+		msg.set_etag("\"v1\"");
+		msg.obody().puts("ok");
+	}
+};
+
+/* a node adding its own header field */
+struct Extra : resource::node {
+	media::type mediatype() const noexcept { return media::json; }
+	void get(micurest::details::message& msg) const noexcept {
+		msg.status(status_t::OK);
+		msg.add_filed("X-Count").puts("1\r\n");
+		msg.obody().puts("[1]");
+	}
+};
+
+static const resource::node& tagged() noexcept {
+	static const Tagged node;
+	return node;
+}
+
+static const resource::node& extra() noexcept {
+	static const Extra node;
+	return node;
+}
+
+static const directory& root() noexcept {
+	return Root<
+		E<name::tagged, tagged>,
+		E<name::extra, extra>
+	>();
+}
+
+#define RUN(name, input) Test015(OMIT(__FILE__),OMIT(name), CSTR(input))
+#define NEG(name, input, result) Test015(OMIT(__FILE__),OMIT(name), CSTR(input), result)
+
+Test015 Test015::tests[] = {
+	RUN("GET /tagged",
+		"GET /tagged HTTP/1.1\r\n\r\n"),
+	RUN("GET /tagged, reused head",
+		"GET /tagged HTTP/1.1\r\nConnection: keep-alive\r\n\r\n"
+		"GET /tagged HTTP/1.1\r\nConnection: keep-alive\r\n\r\n"
+		"GET /tagged HTTP/1.1\r\n\r\n"),
+	RUN("GET /tagged, versions",
+		"GET /tagged HTTP/1.0\r\nConnection: keep-alive\r\n\r\n"
+		"GET /tagged HTTP/0.1\r\nConnection: keep-alive\r\n\r\n"
+		"GET /tagged\r\n\r\n"),
+	RUN("GET /extra, field added by node",
+		"GET /extra HTTP/1.1\r\nConnection: keep-alive\r\n\r\n"
+		"GET /extra HTTP/1.1\r\n\r\n"),
+	NEG("PUT /tagged, not implemented",
+		"PUT /tagged HTTP/1.1\r\n\r\n", application::result_t::bad),
+	NEG("GET /missing",
+		"GET /missing HTTP/1.1\r\nConnection: keep-alive\r\n\r\n",
+		application::result_t::bad),
+};
+
+#undef _T_
+#define _T_ (1500)
+
+static cstring const Master[countof(Test015::tests)] = {
+	 _P_( 0), _P_( 1), _P_( 2), _P_( 3), _P_( 4),
+	 _P_( 5), //_P_( 6), _P_( 7), _P_( 8), _P_( 9),
+};
+
+#include "015.inc"
+
+cstring Test015::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2017 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 15-decimal-value.cpp - cojson tests, code size metrics
+ * metric=read/write fixed-point decimal value
+ * NOTE: These tests are not to be run!
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "bench.hpp"
+using namespace cojson;
+using namespace test;
+
+static decimal<6,2>& decimal1() noexcept {
+	static decimal<6,2> val;
+	return val;
+}
+
+static void run(lexer& in, ostream& out) {
+	V<decimal<6,2>, decimal1>().read(in);
+	V<decimal<6,2>, decimal1>().write(out);
+}
+
+static runner test(run);
+/* x86-64 g++ -Os text: 8160 bytes, 03-double-value: 9782, 00-base: 3717
+ * read+write cycles: 145-224, 03-double-value: 152-315  */
@@ -21,6 +21,7 @@
 
 #include "test.hpp"
 #include "host-env.hpp"
+#include "cojson_utf8.hpp"
 #include <uchar.h>
 
 #define WNAME(s) static inline constexpr const char_t* s() noexcept {return U"" #s;}
@@ -153,6 +154,37 @@ static const value& byref() {
 }
 
 
+/** feeds UTF-8 octets by three, splitting multi-octet sequences */
+struct Octets072 : octetsource {
+	Octets072(const char* s) noexcept : str(s) {}
+	unsigned read(unsigned char* dst, unsigned n) noexcept {
+		unsigned i = 0;
+		for(; i < n && i < 3 && *str; ++i) dst[i] = *str++;
+		return i;
+	}
+	const char* str;
+};
+
+struct Sink072 : octetsink {
+	bool write(const unsigned char* src, unsigned n) noexcept {
+		for(unsigned i = 0; i < n && len < sizeof(data) - 1; ++i)
+			data[len++] = src[i];
+		return true;
+	}
+	char data[64] = {};
+	unsigned len = 0;
+};
+
+static result_t utf8read(const Environment& env, istream& src,
+		const char_t* answer) noexcept {
+	char_t str[32] = {};
+	lexer in(src);
+	bool r = reader<char_t*>::read(str, 32, in);
+	bool m = match(answer, static_cast<const char_t*>(str));
+	env.out(r && m, "%s\n", m ? "match" : "mismatch");
+	return combine2(r, m, in.error());
+}
+
 struct Test072 : Test {
 	static Test072 tests[];
 	inline Test072(tstring name, tstring desc, runner func)
@@ -203,13 +235,38 @@ Test072 Test072::tests[] = {
 				{1, 2, 3, 4, 5, 6}); }),
 	RUN("double/float by ref", {
 		return _R(byref().write(env.output), env);	}),
+	RUN("UTF-8 adapter: contiguous input", {
+		static const char inp[] = "\"Йцуке \xF0\x9F\x98\x80\"";
+		utf8istream src(inp, sizeof(inp) - 1);
+		return utf8read(env, src, U"Йцуке \U0001F600");				}),
+	RUN("UTF-8 adapter: source split in blocks", {
+		Octets072 octets("\"ASCII run, then Ψσμα \xF0\x9F\x98\x80!\"");
+		utf8istream src(octets);
+		return utf8read(env, src, U"ASCII run, then Ψσμα \U0001F600!");	}),
+	RUN("UTF-8 adapter: overlong sequence", {
+		static const char inp[] = "\"ab\xC0\xAF\"";
+		utf8istream src(inp, sizeof(inp) - 1);
+		char_t str[8] = {};
+		lexer in(src);
+		bool r = ! reader<char_t*>::read(str, 8, in);
+		bool m = (in.error() & error_t::bad) != error_t::noerror;
+		return combine2(r, m, error_t::noerror);						}),
+	RUN("UTF-8 adapter: writing", {
+		Sink072 sink;
+		utf8ostream out(sink);
+		bool r = writer<const char_t*>::write(U"Ψ \U0001F600", out) &&
+				 out.flush();
+		bool m = strcmp(sink.data, "\"Ψ \xF0\x9F\x98\x80\"") == 0;
+		env.out(r && m, "%s\n", sink.data);
+		return combine2(r, m, out.error());								}),
 };
 
 #undef  _T_
 #define _T_ (7200)
 static const cstring Master[std::extent<decltype(Test072::tests)>::value] = {
 	_P_(0), _P_(1), _P_(2), _P_(3), _P_(4), _P_(5), _P_(6),
-	_P_(7), _P_(8), _P_(9), _P_(10), _P_(11), _P_(12)
+	_P_(7), _P_(8), _P_(9), _P_(10), _P_(11), _P_(12), _P_(13),
+	_P_(14), _P_(15), _P_(16)
 };
 
 #include "072.inc"
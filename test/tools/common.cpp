@@ -23,7 +23,7 @@
 #include "common.hpp"
 
 #ifndef COJSON_SUITE_SIZE
-#	define COJSON_SUITE_SIZE (200)
+#	define COJSON_SUITE_SIZE (400)
 #endif
 
 namespace cojson {
@@ -28,7 +28,7 @@
 //TODO remove .cpp from text identity, e.g. 101.cpp:4 -> 101:4
 
 #ifndef COJSON_SUITE_SIZE
-#	define COJSON_SUITE_SIZE (200)
+#	define COJSON_SUITE_SIZE (400)
 #endif
 
 #ifndef COJSON_TEST_BUFFER_SIZE